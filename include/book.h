@@ -0,0 +1,49 @@
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <stdint.h>
+#include "game.h"
+
+// --- Bibliothèque d'ouvertures ---
+// Fichier généré hors ligne (outil isola_book) puis projeté en mémoire (mmap)
+// en lecture seule : démarrage immédiat, pages partagées entre processus.
+// Pas de table de finales : isola_book ne produit que des ouvertures. Les finales
+// séparées sont résolues à la volée par le solveur (solver.h) et les autres ont bien
+// trop de positions pour être tabulées. Le format garde BOOK_SOLVED pour un score exact.
+//
+// Format (ordre des octets de la machine) :
+//   BookHeader, puis count BookRecord triés par hash croissant (hash Zobrist de game.c)
+
+#define BOOK_MAGIC "ISOB"
+#define BOOK_VERSION 1
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+} BookHeader;
+
+typedef struct __attribute__((packed)) {
+    uint64_t hash;   // Game.hash de la position (joueur au trait compris)
+    uint8_t to;      // Meilleur tour
+    uint8_t destroy;
+    uint8_t depth;   // Profondeur de la recherche qui l'a trouvé
+    uint8_t flags;   // BOOK_SOLVED si le score est exact
+    int32_t score;   // Du point de vue du joueur au trait
+} BookRecord;
+
+#define BOOK_SOLVED 1
+
+_Static_assert(sizeof(BookHeader) == 16, "BookHeader doit faire 16 octets");
+_Static_assert(sizeof(BookRecord) == 16, "BookRecord doit faire 16 octets");
+
+// Projette le fichier. Renvoie -1 (errno positionné) si absent ou invalide
+int book_open(const char *path);
+// Nombre de positions du livre ouvert (0 si aucun)
+uint64_t book_size(void);
+// Recherche par interpolation. Renvoie 1 et remplit *out si la position est connue
+int book_probe(uint64_t hash, BookRecord *out);
+// Tour du livre pour g, seulement s'il est légal (protège des collisions de hash)
+int book_turn(const Game *g, Turn *out);
+
+#endif //BOOK_H
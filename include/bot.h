@@ -0,0 +1,21 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include <stdint.h>
+#include "game.h"
+
+// --- Bot intégré ---
+// Le joueur bot n'a pas de socket : send_msg() vers BOT_SOCKET ne fait rien.
+// La recherche tourne sur des threads à part, jamais sur un thread réseau :
+// le résultat revient au shard par sa boîte aux lettres (HANDOFF_BOT_TURN).
+#define BOT_SOCKET -1
+#define BOT_NAME "IsolaBot"
+
+// Démarre les threads du bot : threads demandes en parallèle, search_threads
+// threads Lazy SMP par recherche (la table de transposition est allouée par main)
+void bot_start(int threads, int search_threads, int time_ms);
+
+// Demande un coup pour la position g (copiée) ; la réponse arrive au shard donné
+void bot_request(int shard, int game_id, uint32_t seq, const Game *g);
+
+#endif //BOT_H
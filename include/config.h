@@ -3,4 +3,29 @@
 //
 
 #define PORT 55555
-#define MAX_CLIENTS 40
\ No newline at end of file
+#define STATS_PORT 55556        // Métriques en texte sur 127.0.0.1 (option -s, voir metrics.h)
+#define MAX_CLIENTS 40         // Capacité par défaut de chaque shard (option -c)
+#define POOL_CHUNK_CLIENTS 32  // Clients alloués d'un coup quand le pool grandit
+#define POOL_CHUNK_GAMES 64    // Parties allouées d'un coup
+
+// Délais (voir timer.h) : aucun client ne garde un slot indéfiniment
+#define LOGIN_TIMEOUT_MS 30000   // Connexion sans REQ_LOGIN
+#define IDLE_TIMEOUT_MS 300000   // Plus rien reçu du client
+#define TURN_TIMEOUT_MS 60000    // Temps pour jouer un tour complet (sinon partie perdue)
+
+// Matchmaking (voir matchmaking.h)
+#define MM_TICK_MS 100    // Les paires sont formées par lots à ce rythme
+#define MM_EXPORT_MS 2000 // Seul sur son shard plus longtemps : envoyé dans la file du shard 0
+#define ELO_K 32          // Variation max de cote par partie
+
+// Journal des parties (voir journal.h, option -j)
+#define JOURNAL_FSYNC_MS 200 // Écritures couvertes par un fdatasync au plus tard après ce délai (option -f)
+
+// Bot intégré (voir bot.h)
+#define BOT_MATCH_DELAY_MS 10000 // Attente dans la file avant de jouer contre le bot
+#define BOT_RATING 1500          // Cote du bot pour l'Elo des joueurs
+#define BOT_TIME_MS 250          // Temps de réflexion du bot par coup
+#define BOT_THREADS 1            // Parties réfléchies en parallèle (hors threads réseau)
+#define BOT_SEARCH_THREADS 2     // Threads Lazy SMP par coup
+#define BOT_TT_MB 64             // Table de transposition partagée par toutes les recherches
+#define BOOK_PATH "isola.book"   // Livre d'ouvertures (facultatif, option -b, outil isola_book)
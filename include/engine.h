@@ -0,0 +1,34 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stdint.h>
+#include "game.h"
+
+// --- Moteur de recherche (bot) ---
+// Alpha-bêta en approfondissement itératif, sur les règles de src/game.c
+// Table de transposition partagée (tt.h) et Lazy SMP : plusieurs threads
+// cherchent la même racine et profitent des résultats des autres via la table.
+
+#define SCORE_WIN 100000        // Victoire (moins le nombre de demi-coups pour gagner vite)
+#define ENGINE_MAX_THREADS 64   // Threads Lazy SMP max par recherche
+
+typedef struct {
+    int max_depth; // Profondeur max en tours (0 = pas de limite)
+    int time_ms;   // Budget de temps strict pour le coup (0 = pas de limite)
+    int threads;   // Threads de recherche (0 ou 1 = recherche simple)
+} SearchLimits;
+
+typedef struct {
+    Turn best;      // Meilleur tour trouvé
+    int score;      // Du point de vue du joueur qui joue
+    int depth;      // Dernière profondeur terminée
+    uint64_t nodes; // Positions visitées
+} SearchResult;
+
+// Évaluation statique (mobilité) du point de vue du joueur side (0 = P1, 1 = P2)
+int engine_evaluate(const Game *g, int side);
+
+// Cherche le meilleur tour du joueur courant. Renvoie 0 s'il n'a aucun tour légal
+int engine_search(const Game *g, const SearchLimits *limits, SearchResult *result);
+
+#endif //ENGINE_H
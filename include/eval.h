@@ -0,0 +1,28 @@
+#ifndef EVAL_H
+#define EVAL_H
+
+#include <stdint.h>
+#include "game.h"
+
+// --- Évaluation par lots ---
+// Mobilité et surface atteignable en deux pas pour N positions d'un coup.
+// Les positions sont données en colonnes (un tableau par bitboard) : le noyau
+// AVX2 en traite 4 par instruction, sinon repli scalaire (choisi au démarrage
+// selon le processeur, sans option de compilation particulière).
+
+typedef struct {
+    uint8_t mobility[2]; // Cases libres autour du pion de P1 / P2
+    uint8_t area[2];     // Cases libres à deux pas au plus
+} EvalFeatures;
+
+// occupied = trous + deux pions ; pawn_a / pawn_b = un bit chacun
+void eval_features(const Bitboard *occupied, const Bitboard *pawn_a, const Bitboard *pawn_b,
+                   int n, EvalFeatures *out);
+
+// Même chose à partir de parties (génération de données, analyse)
+void eval_games(const Game *games, int n, EvalFeatures *out);
+
+// Nom du noyau choisi ("avx2" ou "scalar")
+const char *eval_kernel_name(void);
+
+#endif //EVAL_H
@@ -0,0 +1,34 @@
+#ifndef FRAMING_H
+#define FRAMING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "protocol.h"
+
+// --- Découpage du flux TCP en messages ---
+// TCP ne garantit pas qu'un recv() rende exactement un GameMessage :
+// on accumule les octets par connexion et on découpe ici.
+// Le format (v1 : GameMessage de 84 octets, v2 : trames compactes) est
+// choisi par connexion, à la première trame reçue.
+
+// Type interne (jamais sur le fil en v1) : poignée de main v2
+#define MSG_HELLO_V2 0
+
+typedef struct {
+    uint8_t version; // 0 = pas encore connu, 1 ou 2
+    uint8_t flags;   // PROTO_V2_FLAG_* acceptés
+} FrameCodec;
+
+// Décode une trame en tête de buf
+// Renvoie le nombre d'octets consommés, 0 si la trame est encore incomplète
+// Une poignée de main v2 donne un message de type MSG_HELLO_V2 (à acquitter)
+size_t frame_decode(FrameCodec *codec, const uint8_t *buf, size_t len, GameMessage *out);
+
+// Taille max d'une trame encodée
+#define FRAME_MAX_SIZE sizeof(GameMessage)
+
+// Encode un message dans out (au moins FRAME_MAX_SIZE octets), renvoie sa taille
+// MSG_HELLO_V2 produit la réponse à la poignée de main
+size_t frame_encode(const FrameCodec *codec, const GameMessage *msg, uint8_t *out);
+
+#endif //FRAMING_H
@@ -1,6 +1,7 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <stdint.h>
 #include "protocol.h" // Pour avoir BOARD_WIDTH et BOARD_HEIGHT
 
 // --- Constantes du Plateau ---
@@ -9,6 +10,30 @@
 #define TILE_P2 2
 #define TILE_DESTROYED -1
 
+// --- Bitboards ---
+// Les 48 cases tiennent dans un uint64_t : bit (y * BOARD_WIDTH + x)
+typedef uint64_t Bitboard;
+
+#define BOARD_CELLS (BOARD_WIDTH * BOARD_HEIGHT)
+#define CELL_INDEX(x, y) ((y) * BOARD_WIDTH + (x))
+#define CELL_X(i) ((i) % BOARD_WIDTH)
+#define CELL_Y(i) ((i) / BOARD_WIDTH)
+
+#define BB_ALL   0x0000FFFFFFFFFFFFULL // Les 48 cases du plateau
+#define BB_COL_0 0x0000010101010101ULL // Colonne x = 0
+#define BB_COL_7 0x0000808080808080ULL // Colonne x = 7
+#define BB_BIT(i) (1ULL << (i))
+
+// Cases d'origine (0,3) et (7,2) : jamais destructibles
+#define BB_ORIGINS (BB_BIT(CELL_INDEX(0, 3)) | BB_BIT(CELL_INDEX(7, 2)))
+
+// Décalages d'un ensemble de cases, sans déborder d'une ligne à l'autre
+#define BB_EAST(b) (((b) << 1) & ~BB_COL_0 & BB_ALL)
+#define BB_WEST(b) (((b) >> 1) & ~BB_COL_7)
+#define BB_ROW_SPREAD(b) ((b) | BB_EAST(b) | BB_WEST(b))
+// Ensemble + ses 8 voisins (dilatation)
+#define BB_DILATE(b) ((BB_ROW_SPREAD(b) | (BB_ROW_SPREAD(b) << 8) | (BB_ROW_SPREAD(b) >> 8)) & BB_ALL)
+
 // --- Phases du tour ---
 // Dans Isola, un tour se fait en 2 étapes : Bouger puis Détruire
 typedef enum {
@@ -22,8 +47,10 @@ typedef enum {
     STATE_INGAME     // En jeu
 } PlayerState;
 
+struct Game;
+
 // --- Structure Joueur ---
-typedef struct {
+typedef struct Player {
     int socket;         // L'ID du socket pour lui parler
     int id_db;          // ID dans la base de données (pour les stats)
     char username[32];  
@@ -32,28 +59,117 @@ typedef struct {
     // Position actuelle (x=colonne, y=ligne)
     int x;
     int y;
+
+    struct Game *game;  // Partie en cours (NULL si aucune)
+
+    // Matchmaking (voir matchmaking.h)
+    int rating;                    // Cote Elo
+    int queued;                    // 1 si dans la file
+    uint64_t queued_at;            // Entrée dans la file (ms), gardée lors d'un transfert
+    struct Player *queue_prev;     // Voisins dans la liste de sa tranche
+    struct Player *queue_next;
 } Player;
 
 // --- Structure Partie ---
-typedef struct {
-    int id;
+// Tient dans une ligne de cache (64 octets)
+typedef struct __attribute__((aligned(64))) Game {
+    Bitboard destroyed; // Cases détruites
+    Bitboard pawns[2];  // Case de P1 / P2 (un seul bit chacun)
+
     Player *p1; // Pointeur vers le joueur 1
     Player *p2; // Pointeur vers le joueur 2
-    
-    int board[BOARD_WIDTH][BOARD_HEIGHT]; // Le plateau 6x8
-    
-    int current_turn; // 1 pour Joueur 1, 2 pour Joueur 2
+
+    uint64_t hash;    // Empreinte Zobrist de la position, tenue à jour à chaque coup
+    int id;
     GamePhase phase;  // Est-ce qu'il doit bouger ou détruire ?
-    
-    int winner;       // 0=Personne, 1=P1, 2=P2
+
+    uint8_t current_turn; // 1 pour Joueur 1, 2 pour Joueur 2
+    uint8_t winner;       // 0=Personne, 1=P1, 2=P2
+    uint8_t pos[2];       // Index de la case de P1 / P2 (0..47)
 } Game;
 
+_Static_assert(sizeof(Game) == 64, "Game doit tenir dans une ligne de cache");
+
+// Voisins de chaque case, précalculés à la compilation
+extern const Bitboard game_neighbors[BOARD_CELLS];
+
+// Cases occupées (trou ou joueur)
+static inline Bitboard game_occupied(const Game *g) {
+    return g->destroyed | g->pawns[0] | g->pawns[1];
+}
+
+// Destinations légales du joueur side (0 = P1, 1 = P2)
+static inline Bitboard game_moves(const Game *g, int side) {
+    return game_neighbors[g->pos[side]] & ~game_occupied(g);
+}
+
+// Cases que l'on peut détruire
+static inline Bitboard game_destroyables(const Game *g) {
+    return ~game_occupied(g) & ~BB_ORIGINS & BB_ALL;
+}
+
+// Nombre de cases libres autour du joueur side
+static inline int game_mobility(const Game *g, int side) {
+    return __builtin_popcountll(game_moves(g, side));
+}
+
+// Un tour complet est-il possible ? Il faut un mouvement, puis une case à détruire
+// autre que la destination (l'ancienne case du pion compte, pas les origines).
+// occupied = trous + deux pions, pawn = le pion du joueur
+static inline int game_can_play(Bitboard occupied, Bitboard pawn) {
+    Bitboard moves = BB_DILATE(pawn) & ~occupied & BB_ALL;
+    Bitboard targets = ((~occupied & BB_ALL) | pawn) & ~BB_ORIGINS;
+
+    if (moves == 0 || targets == 0) return 0;
+    return (targets & (targets - 1)) != 0 || (moves & ~targets) != 0;
+}
+
+static inline int game_has_turn(const Game *g, int side) {
+    return game_can_play(game_occupied(g), g->pawns[side]);
+}
+
+// --- Tour complet par index (pour la recherche, sans Player*) ---
+typedef struct {
+    uint8_t to;      // Case de destination (0..47)
+    uint8_t destroy; // Case détruite (0..47)
+} Turn;
+
+// Au plus 8 destinations x 46 cases à détruire
+#define MAX_TURNS 384
+
+// De quoi défaire un tour joué par game_make_turn()
+typedef struct {
+    uint8_t from;    // Case de départ du joueur
+    uint8_t to;
+    uint8_t destroy;
+} TurnUndo;
+
 // --- Prototypes (Les fonctions qu'on va coder) ---
 void game_init(Game *g, Player *p1, Player *p2);
 int game_check_move(Game *g, Player *p, int x, int y);
 void game_apply_move(Game *g, Player *p, int x, int y);
 int game_check_destroy(Game *g, Player *p, int x, int y);
 void game_apply_destroy(Game *g, int x, int y);
-int game_check_loss(Game *g, Player *p); // Renvoie 1 si le joueur a perdu (bloqué)
+int game_check_loss(Game *g, Player *p); // Renvoie 1 si le joueur a perdu (aucun tour complet possible)
+
+// Tour complet (bouger puis détruire) : la destruction est vérifiée après le mouvement
+int game_check_turn(Game *g, Player *p, int x, int y, int destroy_x, int destroy_y);
+void game_apply_turn(Game *g, Player *p, int x, int y, int destroy_x, int destroy_y);
+
+// Tous les tours légaux du joueur dont c'est le tour, renvoie leur nombre
+int game_gen_turns(const Game *g, Turn *out);
+// Joue / défait un tour légal du joueur courant, sans copie ni Player (pour la recherche)
+// Le hash est mis à jour dans les deux sens : unmake rend exactement la position d'avant
+TurnUndo game_make_turn(Game *g, Turn t);
+void game_unmake_turn(Game *g, TurnUndo u);
+// Hash Zobrist recalculé entièrement (game_init, vérifications)
+uint64_t game_compute_hash(const Game *g);
+// Après un tour : gagnant (1 ou 2) selon les règles du serveur, 0 si la partie continue
+int game_turn_winner(const Game *g);
+// Cases libres que le joueur side peut encore atteindre (remplissage par dilatations)
+Bitboard game_region(const Game *g, int side);
+// 1 si les deux joueurs ne peuvent plus se rejoindre (plateau coupé en deux)
+int game_separated(const Game *g);
+int game_tile_at(const Game *g, int x, int y); // TILE_EMPTY, TILE_P1, TILE_P2 ou TILE_DESTROYED
 
 #endif
\ No newline at end of file
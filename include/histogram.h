@@ -0,0 +1,39 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+// --- Histogramme de latences, classes log-linéaires (style HDR) ---
+// Chaque puissance de 2 est coupée en HIST_SUB classes : ~3 % d'erreur relative
+// sur toute la plage de uint64_t, sans réglage. L'unité (ns, µs) est celle de l'appelant.
+// Un ajout = un compteur incrémenté : assez léger pour le chemin chaud.
+#define HIST_SUB_BITS 5
+#define HIST_SUB (1 << HIST_SUB_BITS)
+#define HIST_CLASSES ((64 - HIST_SUB_BITS) * HIST_SUB)
+
+typedef struct {
+    uint64_t counts[HIST_CLASSES];
+    uint64_t total;
+    uint64_t max;
+} Histogram;
+
+static inline int hist_class(uint64_t v) {
+    if (v < HIST_SUB) return (int)v;
+    int e = 63 - __builtin_clzll(v); // e >= HIST_SUB_BITS
+    return (e - HIST_SUB_BITS + 1) * HIST_SUB + (int)((v >> (e - HIST_SUB_BITS)) & (HIST_SUB - 1));
+}
+
+static inline void hist_add(Histogram *h, uint64_t v) {
+    h->counts[hist_class(v)]++;
+    h->total++;
+    if (v > h->max) h->max = v;
+}
+
+// Plus petite valeur de la classe c
+uint64_t hist_floor(int c);
+// Valeur sous laquelle tombe la fraction q des mesures
+uint64_t hist_quantile(const Histogram *h, double q);
+// Ajoute les mesures de h à into
+void hist_merge(Histogram *into, const Histogram *h);
+
+#endif //HISTOGRAM_H
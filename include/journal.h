@@ -0,0 +1,92 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdint.h>
+#include "game.h"
+
+// --- Journal des parties (option -j) ---
+// Chaque début de partie, mouvement, destruction et fin de partie acceptés est
+// ajouté à un fichier binaire en ajout seul, un par shard. Le shard écrit dans
+// un bloc en mémoire et le passe, en fin de tour de boucle, au thread du
+// journal : celui-ci fait les write() et un fdatasync() groupé au plus tous les
+// fsync_ms (0 = après chaque lot). Le thread réseau ne touche jamais au disque.
+// Relecture : outil isola_replay (fichiers projetés en mémoire).
+//
+// Fichiers <dossier>/shard<N>-<segment>.isj, nouveau segment tous les
+// JOURNAL_SEGMENT_BYTES. Format (ordre des octets de la machine) :
+//   JournalHeader, puis des enregistrements collés, le premier octet donne le type.
+// Une partie est désignée par son numéro de slot (GameSlot.id) : unique dans le
+// journal d'un shard entre son JOURNAL_START et son JOURNAL_END, une partie peut
+// être à cheval sur deux segments.
+
+#define JOURNAL_MAGIC "ISJ1"
+#define JOURNAL_VERSION 1
+#define JOURNAL_BLOCK_SIZE 65536            // Bloc passé au thread du journal
+#define JOURNAL_SEGMENT_BYTES (64ULL << 20) // Taille d'un segment avant le suivant
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint16_t version;
+    uint16_t shard;
+    uint64_t created_ms; // Heure murale (ms depuis 1970)
+} JournalHeader;
+
+typedef enum {
+    JOURNAL_START = 1, // JournalStart + les deux pseudos
+    JOURNAL_MOVE,      // JournalCell (REQ_MOVE)
+    JOURNAL_DESTROY,   // JournalCell (REQ_DESTROY)
+    JOURNAL_TURN,      // JournalTurn (REQ_TURN ou coup du bot)
+    JOURNAL_END        // JournalEnd
+} JournalType;
+
+// Pourquoi la partie s'est arrêtée (JournalEnd.reason)
+typedef enum {
+    JOURNAL_END_BLOCKED = 1, // Un joueur n'a plus de tour possible
+    JOURNAL_END_DECIDED,     // Plateau coupé, issue calculée par le solveur
+    JOURNAL_END_TIMEOUT,     // Temps de tour écoulé (TURN_TIMEOUT_MS)
+    JOURNAL_END_FORFEIT      // Déconnexion en pleine partie
+} JournalEndReason;
+
+typedef struct __attribute__((packed)) {
+    uint8_t type;
+    uint32_t game;
+    uint64_t time_ms;    // Heure murale
+    int16_t rating[2];   // Cotes de P1 et P2 au départ
+    uint8_t name_len[2]; // Suivis des pseudos de P1 puis P2, sans '\0'
+} JournalStart;
+
+typedef struct __attribute__((packed)) {
+    uint8_t type;
+    uint32_t game;
+    uint8_t cell; // CELL_INDEX(x, y)
+} JournalCell;
+
+typedef struct __attribute__((packed)) {
+    uint8_t type;
+    uint32_t game;
+    uint8_t to;
+    uint8_t destroy;
+} JournalTurn;
+
+typedef struct __attribute__((packed)) {
+    uint8_t type;
+    uint32_t game;
+    uint8_t winner; // 1 ou 2
+    uint8_t reason; // JournalEndReason
+    uint64_t time_ms;
+} JournalEnd;
+
+// Active le journal dans dir (créé si besoin) et démarre son thread. Renvoie -1 si échec
+int journal_open(const char *dir, int fsync_ms);
+
+// Ajouts (shard courant) : sans effet si le journal n'est pas actif
+void journal_start(uint32_t game, const Player *p1, const Player *p2);
+void journal_move(uint32_t game, int cell);
+void journal_destroy(uint32_t game, int cell);
+void journal_turn(uint32_t game, int to, int destroy);
+void journal_end(uint32_t game, int winner, int reason);
+
+// Fin de tour de boucle : le bloc en cours part vers le thread du journal
+void journal_commit(void);
+
+#endif //JOURNAL_H
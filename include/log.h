@@ -0,0 +1,60 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// --- Journal asynchrone ---
+// Un appel de log ne formate rien et ne fait aucun appel système : il copie le
+// format (pointeur) et les arguments bruts dans un enregistrement de taille fixe
+// (LOG_RECORD_SIZE) de l'anneau du thread appelant (un producteur, un
+// consommateur, sans verrou). Le thread du journal vide les anneaux, formate et
+// écrit sur stdout. Anneau plein : l'enregistrement est perdu (et compté), le
+// thread réseau n'attend jamais.
+//
+// Le format doit être une chaîne littérale (seul son pointeur est gardé).
+// Conversions reconnues : d i u x X o c s p f g e, modificateurs hh h l ll z j t,
+// largeur et précision (y compris '*'). Les chaînes (%s) sont copiées, tronquées
+// si l'enregistrement est plein.
+
+#define LOG_RECORD_SIZE 128
+#define LOG_RING_RECORDS 4096 // Par thread qui journalise (puissance de 2)
+#define LOG_MAX_RINGS 128     // Threads qui journalisent au plus
+#define LOG_IDLE_MS 5         // Attente du thread du journal quand tout est vide
+
+typedef enum {
+    LOG_ERROR = 0,
+    LOG_WARN,
+    LOG_INFO,
+    LOG_DEBUG
+} LogLevel;
+
+// Niveau courant : les messages plus bavards sont ignorés avant toute copie
+extern atomic_int log_level;
+
+static inline int log_enabled(int level) {
+    return level <= atomic_load_explicit(&log_level, memory_order_relaxed);
+}
+
+#define log_at(level, ...) do { if (log_enabled(level)) log_write(level, __VA_ARGS__); } while (0)
+#define log_error(...) log_at(LOG_ERROR, __VA_ARGS__)
+#define log_warn(...) log_at(LOG_WARN, __VA_ARGS__)
+#define log_info(...) log_at(LOG_INFO, __VA_ARGS__)
+#define log_debug(...) log_at(LOG_DEBUG, __VA_ARGS__)
+
+// Dépose un message dans l'anneau du thread courant (passer par les macros ci-dessus)
+void log_write(int level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+// Démarre le thread du journal (les messages déposés avant attendent). Renvoie -1 si échec
+int log_start(void);
+
+// Vide tout de suite les anneaux sur stdout (fin du programme)
+void log_flush(void);
+
+// Niveau depuis son nom (erreur, alerte, info, debug) ou son numéro, -1 si inconnu
+int log_parse_level(const char *name);
+
+// Gestionnaire de SIGUSR1 : passe au niveau suivant (après debug, retour à erreur)
+void log_on_signal(int sig);
+
+#endif //LOG_H
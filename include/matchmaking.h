@@ -0,0 +1,36 @@
+#ifndef MATCHMAKING_H
+#define MATCHMAKING_H
+
+#include <stdint.h>
+#include "game.h"
+
+// --- File de matchmaking (une par shard) ---
+// Les joueurs sont rangés par tranche de cote : une liste chaînée intrusive
+// (Player.queue_prev / queue_next) par tranche, par ordre d'arrivée, et un
+// bitmap des tranches non vides. Ajout et retrait en O(1), recherche de la
+// tranche voisine la plus proche en quelques instructions sur le bitmap.
+// Les paires sont formées par lots, à chaque tick (voir server_tick dans main.c).
+
+#define MM_DEFAULT_RATING 1200 // Cote d'un joueur qui n'en annonce pas
+#define MM_BUCKET_WIDTH 50     // Points de cote par tranche
+#define MM_BUCKETS 64          // Cotes 0..3199 (les autres sont ramenées aux bords)
+#define MM_MAX_RATING (MM_BUCKETS * MM_BUCKET_WIDTH - 1) // Plus haute cote annonçable
+#define MM_BASE_WINDOW 2       // Tranches acceptées de part et d'autre au départ
+#define MM_WIDEN_MS 1000       // Une tranche de plus par seconde d'attente
+
+// Ajoute p en fin de tranche, ou en tête s'il attend depuis plus longtemps qu'elle.
+// p->queued_at est gardé s'il est déjà posé (joueur transféré d'un autre shard),
+// sinon il vaut now
+void mm_enqueue(Player *p, uint64_t now);
+// Retire p de la file (sans effet s'il n'y est pas)
+void mm_remove(Player *p);
+// Joueurs dans la file du shard
+int mm_size(void);
+
+// Forme une paire compatible (fenêtres élargies selon l'attente) et la retire
+// de la file (*a, le plus ancien, joue en premier). Renvoie 0 s'il n'y en a plus.
+int mm_next_pair(uint64_t now, Player **a, Player **b);
+// Retire et renvoie le joueur le plus ancien s'il attend depuis deadline ou avant
+Player *mm_pop_older_than(uint64_t deadline);
+
+#endif //MATCHMAKING_H
@@ -0,0 +1,58 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <time.h>
+#include "histogram.h"
+#include "shard.h"
+
+// --- Métriques du serveur ---
+// Chaque shard écrit seulement dans ses propres compteurs (pas d'atomique, pas de
+// verrou : une incrémentation ordinaire). Le thread des stats les lit au vol quand
+// quelqu'un se connecte au port de stats (127.0.0.1, option -s) et répond en texte :
+// une ligne "nom{étiquettes} valeur" par mesure, puis fermeture. Une lecture pendant
+// une écriture peut avoir un incrément de retard, ce qui est sans importance ici.
+
+#define METRICS_MSG_TYPES 16       // MessageType 0..14 (0 = MSG_HELLO_V2), 15 = type inconnu
+#define STATS_RETRY_MS 100         // Pause du port de stats quand accept échoue faute de fd
+#define STATS_SEND_TIMEOUT_MS 1000 // Lecteur qui ne lit plus : abandonné après ce délai
+
+typedef struct {
+    // Compteurs
+    uint64_t msg_in[METRICS_MSG_TYPES];  // Messages reçus, par type
+    uint64_t msg_out[METRICS_MSG_TYPES]; // Messages mis en file d'envoi, par type
+    uint64_t bytes_in;                   // Octets reçus
+    uint64_t bytes_out;                  // Octets mis en file d'envoi (trames encodées)
+    uint64_t accepted;                   // Connexions acceptées
+    uint64_t closed;                     // Connexions fermées
+
+    // Jauges, recopiées à chaque tour de boucle
+    uint64_t connections;
+    uint64_t games;
+    uint64_t queued;
+
+    // Latences en ns
+    Histogram handle_ns[METRICS_MSG_TYPES]; // Traitement d'un message reçu, par type
+    Histogram loop_ns;                      // Tour de boucle, de la fin de l'attente à la fin des envois
+} ShardMetrics;
+
+// Métriques du shard courant (allouées par metrics_init_shard)
+extern SHARD_LOCAL ShardMetrics *metrics;
+
+// Alloue et publie les métriques du shard courant
+void metrics_init_shard(void);
+
+// Lance le thread du port de stats (0 = pas de port). Renvoie -1 si échec
+int metrics_start(int port);
+
+static inline int metrics_type(int type) {
+    return (type >= 0 && type < METRICS_MSG_TYPES - 1) ? type : METRICS_MSG_TYPES - 1;
+}
+
+static inline uint64_t metrics_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+#endif //METRICS_H
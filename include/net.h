@@ -0,0 +1,86 @@
+#ifndef NET_H
+#define NET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game.h"
+#include "framing.h"
+#include "timer.h"
+
+// Tampon de réception par connexion (plusieurs messages d'avance)
+#define CONN_RX_SIZE 4096
+
+// File d'envoi par connexion (anneau). Un client qui laisse s'accumuler
+// plus que ça sans lire est trop en retard : on le déconnecte.
+#define CONN_TX_SIZE 4096
+
+// --- Connexion réseau ---
+// Un objet par socket client : c'est lui que le backend renvoie à chaque événement
+typedef struct Connection {
+    int fd;
+    uint32_t slot;    // Numéro dans le pool des clients du shard
+    Player *player;   // Joueur associé (alloué avec la connexion)
+    int backend_slot; // Usage interne du backend (index dans fds[] pour poll)
+
+    // Format de trames négocié (v1 / v2)
+    FrameCodec codec;
+
+    // Octets reçus mais pas encore découpés en messages
+    size_t rx_len;
+    uint8_t rx[CONN_RX_SIZE];
+
+    // Messages en attente d'envoi (anneau : tx_head = début, tx_len = taille)
+    uint32_t tx_head;
+    uint32_t tx_len;
+    uint8_t tx_dirty;   // Déjà dans la liste des connexions à vider
+    struct Connection *pending_next; // Suivante dans cette liste
+    uint8_t tx_polling; // POLLOUT / EPOLLOUT activé
+    uint8_t closing;    // Fermeture demandée, faite après le tour de boucle
+    uint8_t handoff_to; // Part vers un autre shard après ce message (numéro + 1, 0 = non)
+    uint32_t tx_inflight; // Octets confiés au noyau, pas encore confirmés (io_uring)
+    uint32_t gen;         // Génération de la connexion, pour ignorer les vieux événements (epoll, io_uring)
+    Timer idle;           // Login / inactivité (LOGIN_TIMEOUT_MS, IDLE_TIMEOUT_MS)
+    uint8_t tx[CONN_TX_SIZE];
+} Connection;
+
+// --- Backend d'événements ---
+// Une seule implémentation est compilée (option CMake ISOLA_BACKEND : poll ou epoll)
+const char *net_backend_name(void);
+int net_init(int server_fd);
+int net_add(Connection *c);
+int net_add_wakeup(int fd); // eventfd de la boîte aux lettres du shard
+void net_remove(Connection *c);
+
+// Lance l'envoi de ce qui est en file dans c->tx. Renvoie -1 si la connexion est morte
+int net_flush(Connection *c);
+
+// Attend des événements (timeout en ms, -1 = infini) et appelle les callbacks ci-dessous
+// Renvoie -1 en cas d'erreur
+int net_wait(int timeout_ms);
+
+// --- Callbacks (implémentés par le serveur, src/main.c) ---
+// Backends par disponibilité (poll, epoll) : le serveur fait accept / recv lui-même
+void on_accept(int server_fd);
+void on_readable(Connection *c);
+void on_writable(Connection *c);
+// Backends par complétion (io_uring) : le noyau a déjà fait le travail
+void on_accepted(int fd);
+void on_data(Connection *c, const uint8_t *data, size_t len);
+void on_closed(Connection *c);
+// Tous : la boîte aux lettres du shard a du courrier
+void on_wakeup(void);
+// Tous : l'attente est finie, les callbacks du lot vont suivre (appelé à chaque retour d'attente)
+void on_events(void);
+
+// Table indexée par fd (taille = RLIMIT_NOFILE) : NULL si pas de connexion
+Connection *conn_from_fd(int fd);
+
+// --- Outils communs (src/net_common.c) ---
+// Passe un socket en mode non bloquant
+int net_set_nonblocking(int fd);
+
+// poll / epoll : envoie la file avec writev() et (dé)active la surveillance en écriture
+int net_writev_flush(Connection *c);
+void net_want_write(Connection *c, int on);
+
+#endif //NET_H
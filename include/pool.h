@@ -0,0 +1,43 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Pools d'objets de taille fixe (un par type et par shard) ---
+// La mémoire est prise par blocs de `chunk` objets, seulement quand la liste
+// libre est vide : un objet ne bouge jamais, les pointeurs vers lui restent
+// valides. Chaque objet a un numéro stable (pool_at) et occupe un multiple de
+// POOL_ALIGN octets (pas de ligne de cache partagée entre deux objets).
+// La liste libre est intrusive : un objet libre garde le numéro du suivant
+// dans ses 4 premiers octets, réservés par un champ `uint32_t pool_next`
+// en tête de chaque structure poolée.
+
+#define POOL_ALIGN 64
+#define POOL_NONE UINT32_MAX
+
+typedef struct {
+    size_t obj_size;    // Taille d'un objet, arrondie à POOL_ALIGN
+    uint32_t chunk;     // Objets par bloc
+    uint32_t capacity;  // Objets en service au plus
+    uint32_t carved;    // Objets déjà découpés dans les blocs alloués
+    uint32_t live;      // Objets en service
+    uint32_t free_head; // Premier objet libre (POOL_NONE si aucun)
+    uint8_t **chunks;   // Blocs alloués (tableau de capacity / chunk pointeurs)
+} Pool;
+
+// Prépare un pool vide (aucun bloc alloué). Renvoie -1 si échec
+int pool_init(Pool *p, size_t obj_size, uint32_t chunk, uint32_t capacity);
+// Numéro d'un objet libre (POOL_NONE si le pool est plein). Un objet neuf est à zéro,
+// un objet recyclé garde ce qu'il contenait à sa libération
+uint32_t pool_alloc(Pool *p);
+// Rend l'objet id au pool (seuls ses 4 premiers octets sont écrasés)
+void pool_free(Pool *p, uint32_t id);
+
+// Objet numéro id (NULL s'il n'a jamais été découpé)
+static inline void *pool_at(const Pool *p, uint32_t id) {
+    if (id >= p->carved) return NULL;
+    return p->chunks[id / p->chunk] + (size_t)(id % p->chunk) * p->obj_size;
+}
+
+#endif //POOL_H
@@ -14,7 +14,7 @@
 
 typedef enum {
     // Connexion / Lobby
-    REQ_LOGIN = 1,
+    REQ_LOGIN = 1,       // text = pseudo ; val1 = cote annoncée (facultatif, 0 = défaut, bornée par le serveur)
     RES_LOGIN_OK = 2,
     RES_LOGIN_FAIL = 3,
 
@@ -30,7 +30,12 @@ typedef enum {
     NOTIF_GAME_OVER = 10,
     REQ_LOGOUT = 11,
 
-    NOTIF_DESTROY = 12
+    NOTIF_DESTROY = 12,
+
+    // Tour complet en un seul message (bouger + détruire)
+    // val1, val2 = destination ; val3 = case détruite (x + y * BOARD_WIDTH)
+    REQ_TURN = 13,
+    NOTIF_TURN = 14  // Envoyé aux deux joueurs, mêmes champs que REQ_TURN
 
 } MessageType;
 
@@ -50,4 +55,30 @@ typedef struct __attribute__((packed)) {
     char text[64];      // Ex: Nom d'utilisateur, Message d'erreur, Chat
 } GameMessage;
 
+// --- 3. Protocole v2 (compact) ---
+// Négociation : le client commence par envoyer "ISO2" + 1 octet de flags.
+// Le serveur répond "ISO2" + les flags acceptés, puis tout passe en v2.
+// Un client qui commence directement par un GameMessage reste en v1.
+//
+// Trame v2 : [type : 1 octet][len : 1 octet][payload : len octets]
+// Payload selon le type (les champs sont des octets, donc sans question
+// d'ordre des octets ; un futur champ plus large serait en little-endian) :
+//   REQ_MOVE, REQ_DESTROY, RES_MOVE_OK,
+//   NOTIF_OPP_MOVE, NOTIF_DESTROY : [case 0..47] (0xFF = aucune)
+//   REQ_TURN, NOTIF_TURN          : [case destination][case détruite]
+//   NOTIF_GAME_START              : [n° joueur][largeur][hauteur] + nom adverse
+//   NOTIF_GAME_OVER               : [gagnant] + texte
+//   REQ_LOGIN                     : pseudo, puis facultativement [0x00][cote : 2 octets]
+//                                   (sans cote : MM_DEFAULT_RATING)
+//   autres                        : texte seul
+// Le texte vient en fin de payload, sans '\0'. Les messages d'état du serveur
+// ne sont envoyés que si le client a demandé PROTO_V2_FLAG_TEXT.
+#define PROTO_V2_MAGIC "ISO2"
+#define PROTO_V2_MAGIC_SIZE 4
+#define PROTO_V2_HELLO_SIZE (PROTO_V2_MAGIC_SIZE + 1)
+#define PROTO_V2_HEADER_SIZE 2
+#define PROTO_V2_NO_CELL 0xFF
+
+#define PROTO_V2_FLAG_TEXT 0x01 // Le client veut les textes d'état
+
 #endif //PROTOCOL_H
\ No newline at end of file
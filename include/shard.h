@@ -0,0 +1,57 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include "game.h"
+#include "net.h"
+
+// --- Serveur multi-cœurs ---
+// Chaque thread (shard) a son socket d'écoute (SO_REUSEPORT), son backend,
+// ses connexions et ses parties : les variables marquées SHARD_LOCAL sont
+// propres au thread, le chemin chaud du jeu n'a donc aucun verrou.
+#define SHARD_LOCAL _Thread_local
+#define MAX_SHARDS 64
+
+extern int shard_count;              // Nombre de threads (option -t)
+extern SHARD_LOCAL int shard_id;     // Numéro du shard courant (0..shard_count-1)
+
+// --- Canal de passage entre shards ---
+// Les deux joueurs d'une partie doivent vivre sur le même thread :
+// une connexion change de shard en passant par la boîte aux lettres du destinataire.
+// Un joueur sans adversaire sur son shard finit dans la file du shard 0 (MM_EXPORT_MS).
+// La même boîte aux lettres ramène aussi les coups calculés par les threads du bot.
+typedef enum {
+    HANDOFF_MATCH = 1, // Le joueur rejoint la file de matchmaking du shard destinataire
+    HANDOFF_BOT_TURN   // Un thread du bot a fini de réfléchir
+} HandoffKind;
+
+typedef struct Handoff {
+    struct Handoff *next;
+    HandoffKind kind;
+    union {
+        struct {
+            Connection conn;  // Copie de la connexion (fd, octets reçus / à envoyer)
+            Player player;    // Copie du joueur
+        } client;             // HANDOFF_MATCH
+
+        struct {
+            int game_id;      // Numéro de la partie dans le pool du shard
+            uint32_t seq;     // Pour ignorer une réponse arrivée trop tard
+            int found;        // 0 si le bot n'avait aucun tour
+            Turn turn;
+        } bot;                // HANDOFF_BOT_TURN
+    };
+} Handoff;
+
+// Démarre shard_count threads qui exécutent run(id) ; le shard 0 tourne sur l'appelant
+void shard_run_all(void (*run)(int id));
+
+// Crée la boîte aux lettres du shard courant, renvoie l'eventfd à surveiller
+int shard_mailbox_open(void);
+
+// Dépose un passage chez un autre shard et le réveille
+void shard_post(int target, Handoff *h);
+
+// Récupère (dans l'ordre d'arrivée) tout ce qui attend pour le shard courant
+Handoff *shard_take_all(void);
+
+#endif //SHARD_H
@@ -0,0 +1,25 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "game.h"
+
+// --- Solveur exact des fins de partie séparées ---
+// Quand les joueurs ne peuvent plus se rejoindre (game_separated), chacun vit
+// dans sa région : il la parcourt, l'adversaire y détruit une case à chaque tour
+// (détruire ailleurs ne lui rapporte jamais plus). La partie se réduit donc au
+// nombre de tours que chacun tient dans sa région, calculé exactement avec mémo.
+
+// Budgets en positions visitées (mémo compris), au-delà on abandonne (0 renvoyé)
+#define SOLVER_MAX_NODES 50000   // Hors thread réseau (bot, outils)
+#define SOLVER_SEARCH_CELLS 12   // Dans la recherche du bot : < 1 ms par appel
+#define SOLVER_SERVER_CELLS 20   // Après un tour joué sur le serveur (thread réseau)...
+#define SOLVER_SERVER_NODES 4000 // ... avec un petit budget : ~0,1 ms en moyenne, ~1 ms au pire.
+                                 // Abandon : la partie continue, le solveur réessaie au tour
+                                 // suivant sur une région plus petite
+
+// Si la partie est séparée, avec au plus max_cells cases libres dans les deux
+// régions, et résolue en au plus max_nodes positions : renvoie le gagnant (1 ou 2)
+// et met dans *plies le nombre de tours restants avant la fin. Sinon renvoie 0.
+int solver_solve(const Game *g, int max_cells, int max_nodes, int *plies);
+
+#endif //SOLVER_H
@@ -0,0 +1,45 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --- Minuteries du shard (roue hiérarchique) ---
+// TIMER_LEVELS roues de 64 cases : la case d'une échéance dépend des bits
+// de poids fort qui la séparent de l'instant courant. Quand l'heure franchit
+// une case d'une roue haute, ses minuteries redescendent vers les roues basses.
+// Armer et annuler : O(1) (liste doublement chaînée intrusive par case, un
+// bitmap de cases occupées par roue). Résolution : TIMER_TICK_MS.
+// Une roue par shard : une minuterie n'est touchée que par son shard.
+
+#define TIMER_TICK_MS 10
+#define TIMER_LEVELS 4   // 64^4 tics de 10 ms : environ 1,9 jour (au-delà, réarmée en chemin)
+
+typedef struct Timer {
+    struct Timer *next;
+    struct Timer **pprev;     // NULL si la minuterie n'est pas armée
+    uint64_t deadline;        // Échéance (ms, horloge monotone)
+    void (*fire)(struct Timer *t);
+    uint8_t level;
+    uint8_t slot;
+} Timer;
+
+// Retrouve la structure qui contient la minuterie
+#define TIMER_OWNER(t, type, field) ((type *)((char *)(t) - offsetof(type, field)))
+
+// Roue vide, l'heure courante est now (ms)
+void timer_init(uint64_t now);
+// (Ré)arme t pour l'instant deadline (ms). fire est appelée depuis timer_advance()
+void timer_arm(Timer *t, uint64_t deadline, void (*fire)(Timer *t));
+// Sans effet si t n'est pas armée
+void timer_cancel(Timer *t);
+static inline int timer_armed(const Timer *t) {
+    return t->pprev != NULL;
+}
+
+// Déclenche tout ce qui est échu à l'instant now
+void timer_advance(uint64_t now);
+// Délai (ms) avant le prochain travail de la roue, -1 si elle est vide
+int timer_next_ms(uint64_t now);
+
+#endif //TIMER_H
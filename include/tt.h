@@ -0,0 +1,36 @@
+#ifndef TT_H
+#define TT_H
+
+#include <stdint.h>
+#include "game.h"
+
+// --- Table de transposition ---
+// Partagée sans verrou par tous les threads de recherche (bot, Lazy SMP).
+// Une entrée = 16 octets : (hash ^ data, data). Les deux mots sont écrits
+// séparément ; une lecture qui mélange deux écritures donne un hash faux
+// et l'entrée est simplement ignorée.
+
+typedef enum {
+    TT_NONE = 0,
+    TT_EXACT,  // Score exact
+    TT_LOWER,  // Score >= valeur (coupure beta)
+    TT_UPPER   // Score <= valeur (aucun tour n'a dépassé alpha)
+} TTBound;
+
+typedef struct {
+    int score;
+    int depth;
+    TTBound bound;
+    Turn best;  // to = 0xFF si inconnu
+} TTEntry;
+
+// Alloue la table (taille arrondie à une puissance de 2). Renvoie -1 si échec
+int tt_init(size_t size_mb);
+// Nouvelle recherche : les entrées des recherches précédentes deviennent remplaçables
+void tt_new_search(void);
+// Renvoie 1 et remplit e si la position est dans la table
+int tt_probe(uint64_t hash, TTEntry *e);
+// Remplacement : on garde l'entrée la plus profonde, sauf si elle est d'une ancienne recherche
+void tt_store(uint64_t hash, int depth, TTBound bound, int score, Turn best);
+
+#endif //TT_H
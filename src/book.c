@@ -0,0 +1,85 @@
+//
+// Livre d'ouvertures projeté en mémoire, recherche par interpolation
+//
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/book.h"
+
+static const BookRecord *records = NULL;
+static uint64_t record_count = 0;
+
+int book_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(BookHeader)) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // La projection reste valable
+    if (map == MAP_FAILED) return -1;
+
+    const BookHeader *h = map;
+    if (memcmp(h->magic, BOOK_MAGIC, 4) != 0 || h->version != BOOK_VERSION
+        || h->count > ((size_t)st.st_size - sizeof(BookHeader)) / sizeof(BookRecord)) {
+        munmap(map, (size_t)st.st_size);
+        errno = EINVAL;
+        return -1;
+    }
+
+    // Lecture surtout aléatoire : pas la peine de lire en avance
+    madvise(map, (size_t)st.st_size, MADV_RANDOM);
+
+    records = (const BookRecord *)(h + 1);
+    record_count = h->count;
+    return 0;
+}
+
+uint64_t book_size(void) {
+    return record_count;
+}
+
+// Les hash Zobrist sont uniformes : on vise directement la bonne zone du tableau
+int book_probe(uint64_t hash, BookRecord *out) {
+    if (record_count == 0) return 0;
+
+    uint64_t lo = 0;
+    uint64_t hi = record_count - 1;
+    while (lo <= hi && hash >= records[lo].hash && hash <= records[hi].hash) {
+        uint64_t span = records[hi].hash - records[lo].hash;
+        uint64_t mid = lo;
+        if (span != 0) mid += (uint64_t)((unsigned __int128)(hash - records[lo].hash) * (hi - lo) / span);
+
+        if (records[mid].hash == hash) {
+            *out = records[mid];
+            return 1;
+        }
+        if (records[mid].hash < hash) lo = mid + 1;
+        else if (mid == 0) break;
+        else hi = mid - 1;
+    }
+    return 0;
+}
+
+int book_turn(const Game *g, Turn *out) {
+    BookRecord r;
+    if (!book_probe(g->hash, &r)) return 0;
+
+    Turn turns[MAX_TURNS];
+    int n = game_gen_turns(g, turns);
+    for (int i = 0; i < n; i++) {
+        if (turns[i].to == r.to && turns[i].destroy == r.destroy) {
+            *out = turns[i];
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+//
+// Threads de recherche du bot : file de demandes -> engine_search -> boîte aux lettres du shard
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "../include/bot.h"
+#include "../include/engine.h"
+#include "../include/book.h"
+#include "../include/shard.h"
+
+typedef struct BotJob {
+    struct BotJob *next;
+    int shard;
+    int game_id;
+    uint32_t seq;
+    Game game;
+} BotJob;
+
+static pthread_mutex_t jobs_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobs_cond = PTHREAD_COND_INITIALIZER;
+static BotJob *jobs_head = NULL;
+static BotJob *jobs_tail = NULL;
+static int bot_time_ms = 0;
+static int bot_search_threads = 1;
+
+static void *bot_thread(void *arg) {
+    (void)arg;
+    while (1) {
+        pthread_mutex_lock(&jobs_lock);
+        while (jobs_head == NULL) pthread_cond_wait(&jobs_cond, &jobs_lock);
+        BotJob *job = jobs_head;
+        jobs_head = job->next;
+        if (jobs_head == NULL) jobs_tail = NULL;
+        pthread_mutex_unlock(&jobs_lock);
+
+        SearchLimits limits = { 0, bot_time_ms, bot_search_threads };
+        SearchResult result;
+
+        Handoff *h = malloc(sizeof(Handoff));
+        if (h != NULL) {
+            h->kind = HANDOFF_BOT_TURN;
+            h->bot.game_id = job->game_id;
+            h->bot.seq = job->seq;
+            // Position du livre : réponse immédiate, sinon recherche
+            if (book_turn(&job->game, &h->bot.turn)) {
+                h->bot.found = 1;
+            } else {
+                h->bot.found = engine_search(&job->game, &limits, &result);
+                h->bot.turn = result.best;
+            }
+            shard_post(job->shard, h);
+        }
+        free(job);
+    }
+    return NULL;
+}
+
+void bot_start(int threads, int search_threads, int time_ms) {
+    bot_time_ms = time_ms;
+    bot_search_threads = search_threads;
+    for (int i = 0; i < threads; i++) {
+        pthread_t t;
+        if (pthread_create(&t, NULL, bot_thread, NULL) != 0) {
+            perror("Echec pthread_create (bot)");
+            exit(EXIT_FAILURE);
+        }
+        pthread_detach(t);
+    }
+}
+
+void bot_request(int shard, int game_id, uint32_t seq, const Game *g) {
+    BotJob *job = malloc(sizeof(BotJob));
+    if (job == NULL) return;
+
+    job->next = NULL;
+    job->shard = shard;
+    job->game_id = game_id;
+    job->seq = seq;
+    job->game = *g;
+    // La recherche ne doit pas toucher aux joueurs du thread réseau
+    job->game.p1 = NULL;
+    job->game.p2 = NULL;
+
+    pthread_mutex_lock(&jobs_lock);
+    if (jobs_tail) jobs_tail->next = job;
+    else jobs_head = job;
+    jobs_tail = job;
+    pthread_cond_signal(&jobs_cond);
+    pthread_mutex_unlock(&jobs_lock);
+}
@@ -0,0 +1,317 @@
+//
+// Moteur de recherche pour le bot : alpha-bêta + approfondissement itératif
+//
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "../include/engine.h"
+#include "../include/tt.h"
+#include "../include/solver.h"
+#include "../include/eval.h"
+
+#define TIME_CHECK_MASK 1023 // On regarde l'heure (et le signal d'arrêt) toutes les 1024 positions
+#define MATE_BOUND (SCORE_WIN - 1000) // Au-delà : score de gain / perte forcés
+#define ENGINE_SOLVED_DEPTH 255       // Profondeur des positions résolues dans la table
+
+typedef struct {
+    uint64_t deadline_ns;
+    uint64_t nodes;
+    int aborted;
+    atomic_int *stop; // Levé par le thread principal quand la recherche est finie
+} SearchCtx;
+
+// Un thread de recherche : le principal (id 0) ou un assistant Lazy SMP
+typedef struct {
+    int id;
+    const Game *root;
+    const SearchLimits *limits;
+    SearchCtx ctx;
+    SearchResult result;
+} SearchThread;
+
+static const Turn no_turn = { 0xFF, 0xFF };
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Mobilité immédiate (x4) + cases atteignables en deux pas
+int engine_evaluate(const Game *g, int side) {
+    Bitboard empty = ~game_occupied(g) & BB_ALL;
+    Bitboard m_me = game_moves(g, side);
+    Bitboard m_opp = game_moves(g, side ^ 1);
+    Bitboard r_me = BB_DILATE(m_me) & empty;
+    Bitboard r_opp = BB_DILATE(m_opp) & empty;
+
+    return 4 * (__builtin_popcountll(m_me) - __builtin_popcountll(m_opp))
+         + __builtin_popcountll(r_me) - __builtin_popcountll(r_opp);
+}
+
+// Tri des tours : on essaie d'abord les destinations qui gardent le plus de
+// libertés et les destructions collées à l'adversaire (elles le privent de cases)
+static void order_turns(const Game *g, Turn *turns, int n, Turn first) {
+    int side = g->current_turn - 1;
+    Bitboard opp_near = game_neighbors[g->pos[side ^ 1]];
+    Bitboard opp_ring2 = BB_DILATE(opp_near);
+    Bitboard blocked = g->destroyed | g->pawns[side ^ 1];
+    int keys[MAX_TURNS];
+
+    for (int i = 0; i < n; i++) {
+        Bitboard d = BB_BIT(turns[i].destroy);
+        int key = 4 * __builtin_popcountll(game_neighbors[turns[i].to] & ~blocked & ~d);
+        if (opp_near & d) key += 64;
+        else if (opp_ring2 & d) key += 16;
+        if (turns[i].to == first.to && turns[i].destroy == first.destroy) key = 1 << 20;
+        keys[i] = key;
+    }
+
+    // Tri par insertion (clé décroissante)
+    for (int i = 1; i < n; i++) {
+        Turn t = turns[i];
+        int k = keys[i];
+        int j = i - 1;
+        while (j >= 0 && keys[j] < k) {
+            turns[j + 1] = turns[j];
+            keys[j + 1] = keys[j];
+            j--;
+        }
+        turns[j + 1] = t;
+        keys[j + 1] = k;
+    }
+}
+
+// Les gains / pertes sont stockés relativement à la position (et non à la racine)
+static int score_to_tt(int score, int ply) {
+    if (score > MATE_BOUND) return score + ply;
+    if (score < -MATE_BOUND) return score - ply;
+    return score;
+}
+
+static int score_from_tt(int score, int ply) {
+    if (score > MATE_BOUND) return score - ply;
+    if (score < -MATE_BOUND) return score + ply;
+    return score;
+}
+
+// Compte n positions de plus ; à chaque passage d'un multiple de 1024, on regarde l'heure
+static int out_of_time(SearchCtx *ctx, int n) {
+    uint64_t before = ctx->nodes;
+    ctx->nodes += (uint64_t)n;
+    if ((before | TIME_CHECK_MASK) < ctx->nodes) {
+        if (atomic_load_explicit(ctx->stop, memory_order_relaxed) || now_ns() >= ctx->deadline_ns) {
+            ctx->aborted = 1;
+        }
+    }
+    return ctx->aborted;
+}
+
+// Profondeur 1 : tous les enfants passent d'un coup dans le noyau de eval.c
+// (ni tri ni coupure : l'évaluation par lot revient moins cher)
+static int leaf_batch(SearchCtx *ctx, const Game *g, const Turn *turns, int n, int ply, Turn *best_turn) {
+    int side = g->current_turn - 1;
+    Bitboard base = g->destroyed | g->pawns[side ^ 1];
+    Bitboard occupied[MAX_TURNS], me[MAX_TURNS], opp[MAX_TURNS];
+    EvalFeatures f[MAX_TURNS];
+
+    if (out_of_time(ctx, n)) return 0;
+
+    for (int i = 0; i < n; i++) {
+        me[i] = BB_BIT(turns[i].to);
+        opp[i] = g->pawns[side ^ 1];
+        occupied[i] = base | me[i] | BB_BIT(turns[i].destroy);
+    }
+    eval_features(occupied, me, opp, n, f);
+
+    int best = -SCORE_WIN - 1;
+    for (int i = 0; i < n; i++) {
+        // Même règle que game_turn_winner : l'adversaire bloqué d'abord
+        int score;
+        if (f[i].mobility[1] == 0 || !game_can_play(occupied[i], opp[i])) score = SCORE_WIN - ply - 1;
+        else if (f[i].mobility[0] == 0 || !game_can_play(occupied[i], me[i])) score = -(SCORE_WIN - ply - 1);
+        else score = 4 * (f[i].mobility[0] - f[i].mobility[1]) + f[i].area[0] - f[i].area[1];
+
+        if (score > best) {
+            best = score;
+            *best_turn = turns[i];
+        }
+    }
+    return best;
+}
+
+// Parcours sans copie : chaque tour est joué puis défait sur la même partie
+static int negamax(SearchCtx *ctx, Game *g, int depth, int alpha, int beta, int ply) {
+    int alpha_start = alpha;
+    Turn tt_turn = no_turn;
+    TTEntry e;
+
+    if (tt_probe(g->hash, &e)) {
+        tt_turn = e.best;
+        if (e.depth >= depth) {
+            int score = score_from_tt(e.score, ply);
+            if (e.bound == TT_EXACT) return score;
+            if (e.bound == TT_LOWER && score >= beta) return score;
+            if (e.bound == TT_UPPER && score <= alpha) return score;
+        }
+    }
+
+    // Plateau coupé en deux : résultat exact sans chercher
+    int plies;
+    int solved = solver_solve(g, SOLVER_SEARCH_CELLS, SOLVER_MAX_NODES, &plies);
+    if (solved) {
+        int score = SCORE_WIN - ply - plies;
+        score = (solved == g->current_turn) ? score : -score;
+        tt_store(g->hash, ENGINE_SOLVED_DEPTH, TT_EXACT, score_to_tt(score, ply), no_turn);
+        return score;
+    }
+
+    Turn turns[MAX_TURNS];
+    int n = game_gen_turns(g, turns);
+    int side = g->current_turn - 1;
+
+    if (n == 0) return -(SCORE_WIN - ply); // Bloqué
+
+    int best = -SCORE_WIN - 1;
+    Turn best_turn = turns[0];
+    if (depth <= 1) {
+        best = leaf_batch(ctx, g, turns, n, ply, &best_turn);
+        n = 0; // Déjà évalués
+    } else {
+        order_turns(g, turns, n, tt_turn);
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (out_of_time(ctx, 1)) return 0;
+
+        TurnUndo undo = game_make_turn(g, turns[i]);
+
+        int score;
+        int winner = game_turn_winner(g);
+        if (winner) score = (winner == side + 1) ? SCORE_WIN - ply - 1 : -(SCORE_WIN - ply - 1);
+        else score = -negamax(ctx, g, depth - 1, -beta, -alpha, ply + 1);
+
+        game_unmake_turn(g, undo);
+
+        if (score > best) {
+            best = score;
+            best_turn = turns[i];
+        }
+        if (score > alpha) alpha = score;
+        if (alpha >= beta) break;
+    }
+    if (ctx->aborted) return 0;
+
+    TTBound bound = (best <= alpha_start) ? TT_UPPER : (best >= beta) ? TT_LOWER : TT_EXACT;
+    tt_store(g->hash, depth, bound, score_to_tt(best, ply), best_turn);
+    return best;
+}
+
+// Approfondissement itératif d'un thread. Les assistants commencent une profondeur
+// plus loin un sur deux : ils remplissent la table pour le thread principal
+static void iterate(SearchThread *t) {
+    Game work = *t->root; // Seule copie de la recherche
+    Game *g = &work;
+    SearchCtx *ctx = &t->ctx;
+    SearchResult *result = &t->result;
+    Turn turns[MAX_TURNS];
+    int n = game_gen_turns(g, turns);
+    int side = g->current_turn - 1;
+
+    // Par défaut : le tour de la table, sinon le premier dans l'ordre heuristique
+    TTEntry e;
+    order_turns(g, turns, n, tt_probe(g->hash, &e) ? e.best : no_turn);
+    result->best = turns[0];
+
+    int max_depth = t->limits->max_depth;
+    for (int depth = 1 + (t->id & 1); max_depth == 0 || depth <= max_depth; depth++) {
+        int alpha = -SCORE_WIN - 1;
+        int best_index = 0;
+
+        for (int i = 0; i < n && !ctx->aborted; i++) {
+            TurnUndo undo = game_make_turn(g, turns[i]);
+            ctx->nodes++;
+
+            int score;
+            int winner = game_turn_winner(g);
+            if (winner) score = (winner == side + 1) ? SCORE_WIN - 1 : -(SCORE_WIN - 1);
+            else if (depth == 1) score = engine_evaluate(g, side);
+            else score = -negamax(ctx, g, depth - 1, -SCORE_WIN - 1, -alpha, 1);
+
+            game_unmake_turn(g, undo);
+
+            if (!ctx->aborted && score > alpha) {
+                alpha = score;
+                best_index = i;
+            }
+        }
+
+        // Itération interrompue : on garde le résultat de la précédente
+        if (ctx->aborted) break;
+
+        result->best = turns[best_index];
+        result->score = alpha;
+        result->depth = depth;
+        tt_store(g->hash, depth, TT_EXACT, alpha, result->best);
+
+        // Le meilleur tour passe en tête pour l'itération suivante
+        order_turns(g, turns, n, result->best);
+
+        // Gain ou perte forcés : inutile d'aller plus loin
+        if (alpha >= MATE_BOUND || alpha <= -MATE_BOUND) break;
+        if (atomic_load_explicit(ctx->stop, memory_order_relaxed) || now_ns() >= ctx->deadline_ns) break;
+    }
+    result->nodes = ctx->nodes;
+}
+
+static void *helper_thread(void *arg) {
+    iterate(arg);
+    return NULL;
+}
+
+int engine_search(const Game *root, const SearchLimits *limits, SearchResult *result) {
+    Turn turns[MAX_TURNS];
+    memset(result, 0, sizeof(*result));
+    if (game_gen_turns(root, turns) == 0) return 0;
+
+    int count = limits->threads;
+    if (count < 1) count = 1;
+    if (count > ENGINE_MAX_THREADS) count = ENGINE_MAX_THREADS;
+
+    atomic_int stop = 0;
+    uint64_t deadline = (limits->time_ms > 0) ? now_ns() + (uint64_t)limits->time_ms * 1000000ULL : UINT64_MAX;
+    SearchThread threads[ENGINE_MAX_THREADS];
+    pthread_t handles[ENGINE_MAX_THREADS];
+
+    tt_new_search();
+    for (int i = 0; i < count; i++) {
+        memset(&threads[i], 0, sizeof(SearchThread));
+        threads[i].id = i;
+        threads[i].root = root;
+        threads[i].limits = limits;
+        threads[i].ctx.deadline_ns = deadline;
+        threads[i].ctx.stop = &stop;
+    }
+
+    // Lazy SMP : tous les threads cherchent la même racine, seule la table est partagée
+    int started = 1;
+    while (started < count && pthread_create(&handles[started], NULL, helper_thread, &threads[started]) == 0) {
+        started++;
+    }
+    iterate(&threads[0]);
+    atomic_store(&stop, 1);
+
+    // Résultat du thread principal, sauf si un assistant a fini une itération plus profonde
+    *result = threads[0].result;
+    for (int i = 1; i < started; i++) {
+        pthread_join(handles[i], NULL);
+        if (threads[i].result.depth > result->depth) {
+            result->best = threads[i].result.best;
+            result->score = threads[i].result.score;
+            result->depth = threads[i].result.depth;
+        }
+    }
+    for (int i = 1; i < started; i++) result->nodes += threads[i].result.nodes;
+    return 1;
+}
@@ -0,0 +1,127 @@
+//
+// Noyau d'évaluation par lots : AVX2 si disponible, sinon scalaire
+//
+#include <stdatomic.h>
+#include "../include/eval.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define EVAL_HAVE_AVX2 1
+#endif
+
+typedef void (*EvalKernel)(const Bitboard *, const Bitboard *, const Bitboard *, int, EvalFeatures *);
+
+static void features_scalar(const Bitboard *occupied, const Bitboard *pawn_a, const Bitboard *pawn_b,
+                            int n, EvalFeatures *out) {
+    for (int i = 0; i < n; i++) {
+        Bitboard empty = ~occupied[i] & BB_ALL;
+        Bitboard ma = BB_DILATE(pawn_a[i]) & empty;
+        Bitboard mb = BB_DILATE(pawn_b[i]) & empty;
+
+        out[i].mobility[0] = (uint8_t)__builtin_popcountll(ma);
+        out[i].mobility[1] = (uint8_t)__builtin_popcountll(mb);
+        out[i].area[0] = (uint8_t)__builtin_popcountll(BB_DILATE(ma) & empty);
+        out[i].area[1] = (uint8_t)__builtin_popcountll(BB_DILATE(mb) & empty);
+    }
+}
+
+#ifdef EVAL_HAVE_AVX2
+#define AVX2 __attribute__((target("avx2")))
+
+// BB_DILATE sur 4 bitboards à la fois (east_mask = BB_ALL sans la colonne 0, comme BB_EAST)
+static inline AVX2 __m256i dilate4(__m256i b, __m256i all, __m256i east_mask, __m256i col7) {
+    __m256i east = _mm256_and_si256(east_mask, _mm256_slli_epi64(b, 1));
+    __m256i west = _mm256_andnot_si256(col7, _mm256_srli_epi64(b, 1));
+    __m256i row = _mm256_or_si256(b, _mm256_or_si256(east, west));
+    __m256i rows = _mm256_or_si256(row, _mm256_or_si256(_mm256_slli_epi64(row, 8), _mm256_srli_epi64(row, 8)));
+    return _mm256_and_si256(rows, all);
+}
+
+// popcount des 4 mots de 64 bits (table de 16 entrées par demi-octet)
+static inline AVX2 __m256i popcount4(__m256i v) {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, low));
+    __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+static AVX2 void features_avx2(const Bitboard *occupied, const Bitboard *pawn_a, const Bitboard *pawn_b,
+                               int n, EvalFeatures *out) {
+    const __m256i all = _mm256_set1_epi64x((long long)BB_ALL);
+    const __m256i east_mask = _mm256_set1_epi64x((long long)(BB_ALL & ~BB_COL_0));
+    const __m256i col7 = _mm256_set1_epi64x((long long)BB_COL_7);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i occ = _mm256_loadu_si256((const __m256i *)(occupied + i));
+        __m256i a = _mm256_loadu_si256((const __m256i *)(pawn_a + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(pawn_b + i));
+        __m256i empty = _mm256_andnot_si256(occ, all);
+
+        __m256i ma = _mm256_and_si256(dilate4(a, all, east_mask, col7), empty);
+        __m256i mb = _mm256_and_si256(dilate4(b, all, east_mask, col7), empty);
+        __m256i ra = _mm256_and_si256(dilate4(ma, all, east_mask, col7), empty);
+        __m256i rb = _mm256_and_si256(dilate4(mb, all, east_mask, col7), empty);
+
+        uint64_t c[4][4];
+        _mm256_storeu_si256((__m256i *)c[0], popcount4(ma));
+        _mm256_storeu_si256((__m256i *)c[1], popcount4(mb));
+        _mm256_storeu_si256((__m256i *)c[2], popcount4(ra));
+        _mm256_storeu_si256((__m256i *)c[3], popcount4(rb));
+        for (int k = 0; k < 4; k++) {
+            out[i + k].mobility[0] = (uint8_t)c[0][k];
+            out[i + k].mobility[1] = (uint8_t)c[1][k];
+            out[i + k].area[0] = (uint8_t)c[2][k];
+            out[i + k].area[1] = (uint8_t)c[3][k];
+        }
+    }
+    features_scalar(occupied + i, pawn_a + i, pawn_b + i, n - i, out + i);
+}
+#endif
+
+static _Atomic(EvalKernel) kernel = NULL;
+static const char *kernel_name = "scalar";
+
+static EvalKernel select_kernel(void) {
+    EvalKernel k = atomic_load_explicit(&kernel, memory_order_acquire);
+    if (k != NULL) return k;
+
+    k = features_scalar;
+#ifdef EVAL_HAVE_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        k = features_avx2;
+        kernel_name = "avx2";
+    }
+#endif
+    atomic_store_explicit(&kernel, k, memory_order_release);
+    return k;
+}
+
+void eval_features(const Bitboard *occupied, const Bitboard *pawn_a, const Bitboard *pawn_b,
+                   int n, EvalFeatures *out) {
+    select_kernel()(occupied, pawn_a, pawn_b, n, out);
+}
+
+#define GAMES_CHUNK 64
+
+void eval_games(const Game *games, int n, EvalFeatures *out) {
+    Bitboard occ[GAMES_CHUNK], a[GAMES_CHUNK], b[GAMES_CHUNK];
+
+    for (int i = 0; i < n; i += GAMES_CHUNK) {
+        int m = (n - i < GAMES_CHUNK) ? n - i : GAMES_CHUNK;
+        for (int k = 0; k < m; k++) {
+            occ[k] = game_occupied(&games[i + k]);
+            a[k] = games[i + k].pawns[0];
+            b[k] = games[i + k].pawns[1];
+        }
+        eval_features(occ, a, b, m, out + i);
+    }
+}
+
+const char *eval_kernel_name(void) {
+    select_kernel();
+    return kernel_name;
+}
@@ -0,0 +1,200 @@
+//
+// Découpage du flux TCP en messages GameMessage (v1 et v2)
+//
+#include <string.h>
+#include "../include/framing.h"
+#include "../include/game.h"
+
+// Forme du payload v2 selon le type
+typedef enum {
+    V2_TEXT = 0, // Texte seul
+    V2_CELL,     // 1 case (val1 = x, val2 = y)
+    V2_TURN,     // 2 cases (val1 = x, val2 = y, val3 = index de la case détruite)
+    V2_VAL1,     // val1 sur 1 octet
+    V2_VAL3,     // val1, val2, val3 sur 1 octet chacun
+    V2_LOGIN     // Texte, puis facultativement '\0' + val1 sur 2 octets (little-endian)
+} V2Layout;
+
+static V2Layout v2_layout(int type) {
+    switch (type) {
+        case REQ_MOVE:
+        case REQ_DESTROY:
+        case RES_MOVE_OK:
+        case NOTIF_OPP_MOVE:
+        case NOTIF_DESTROY:
+            return V2_CELL;
+        case REQ_TURN:
+        case NOTIF_TURN:
+            return V2_TURN;
+        case NOTIF_GAME_START:
+            return V2_VAL3;
+        case NOTIF_GAME_OVER:
+            return V2_VAL1;
+        case REQ_LOGIN:
+            return V2_LOGIN;
+        default:
+            return V2_TEXT;
+    }
+}
+
+// Le texte est une donnée (pas un message d'état) : toujours envoyé
+static int v2_text_is_data(int type) {
+    return type == REQ_LOGIN || type == NOTIF_GAME_START;
+}
+
+static uint8_t cell_of(int x, int y) {
+    if (x < 0 || x >= BOARD_WIDTH || y < 0 || y >= BOARD_HEIGHT) return PROTO_V2_NO_CELL;
+    return (uint8_t)CELL_INDEX(x, y);
+}
+
+static size_t decode_v1(const uint8_t *buf, size_t len, GameMessage *out) {
+    if (len < sizeof(GameMessage)) return 0;
+
+    memcpy(out, buf, sizeof(GameMessage));
+    out->text[sizeof(out->text) - 1] = '\0'; // On ne fait pas confiance au client
+    return sizeof(GameMessage);
+}
+
+static size_t decode_v2(const uint8_t *buf, size_t len, GameMessage *out) {
+    if (len < PROTO_V2_HEADER_SIZE) return 0;
+    size_t payload_len = buf[1];
+    if (len < PROTO_V2_HEADER_SIZE + payload_len) return 0;
+
+    const uint8_t *payload = buf + PROTO_V2_HEADER_SIZE;
+    size_t fixed = 0;
+
+    memset(out, 0, sizeof(*out));
+    out->type = buf[0];
+
+    switch (v2_layout(out->type)) {
+        case V2_CELL:
+            // Trame tronquée : aucune case (surtout pas 0,0 laissé par le memset)
+            if (payload_len < 1) { out->val1 = out->val2 = -1; break; }
+            if (payload[0] < BOARD_CELLS) {
+                out->val1 = CELL_X(payload[0]);
+                out->val2 = CELL_Y(payload[0]);
+            } else {
+                out->val1 = out->val2 = -1;
+            }
+            fixed = 1;
+            break;
+        case V2_TURN:
+            if (payload_len < 2) { out->val1 = out->val2 = out->val3 = -1; break; }
+            if (payload[0] < BOARD_CELLS) {
+                out->val1 = CELL_X(payload[0]);
+                out->val2 = CELL_Y(payload[0]);
+            } else {
+                out->val1 = out->val2 = -1;
+            }
+            out->val3 = (payload[1] < BOARD_CELLS) ? payload[1] : -1;
+            fixed = 2;
+            break;
+        case V2_VAL1:
+            if (payload_len < 1) break;
+            out->val1 = payload[0];
+            fixed = 1;
+            break;
+        case V2_VAL3:
+            if (payload_len < 3) break;
+            out->val1 = payload[0];
+            out->val2 = payload[1];
+            out->val3 = payload[2];
+            fixed = 3;
+            break;
+        case V2_LOGIN: {
+            // Le texte copié plus bas s'arrête au '\0', la cote le suit
+            const uint8_t *end = memchr(payload, '\0', payload_len);
+            if (end != NULL && (size_t)(end - payload) + 3 <= payload_len) {
+                out->val1 = end[1] | (end[2] << 8);
+            }
+            break;
+        }
+        case V2_TEXT:
+            break;
+    }
+
+    size_t text_len = payload_len - fixed;
+    if (text_len > sizeof(out->text) - 1) text_len = sizeof(out->text) - 1;
+    memcpy(out->text, payload + fixed, text_len);
+
+    return PROTO_V2_HEADER_SIZE + payload_len;
+}
+
+size_t frame_decode(FrameCodec *codec, const uint8_t *buf, size_t len, GameMessage *out) {
+    if (len == 0) return 0;
+
+    // Première trame : "ISO2..." -> v2, sinon c'est un GameMessage v1
+    // (un type v1 valide ne commence jamais par l'octet 'I')
+    if (codec->version == 0) {
+        if (buf[0] != (uint8_t)PROTO_V2_MAGIC[0]) {
+            codec->version = 1;
+        } else {
+            if (len < PROTO_V2_HELLO_SIZE) return 0;
+            if (memcmp(buf, PROTO_V2_MAGIC, PROTO_V2_MAGIC_SIZE) != 0) {
+                codec->version = 1;
+            } else {
+                codec->version = 2;
+                codec->flags = buf[PROTO_V2_MAGIC_SIZE] & PROTO_V2_FLAG_TEXT;
+                memset(out, 0, sizeof(*out));
+                out->type = MSG_HELLO_V2;
+                return PROTO_V2_HELLO_SIZE;
+            }
+        }
+    }
+
+    if (codec->version == 2) return decode_v2(buf, len, out);
+    return decode_v1(buf, len, out);
+}
+
+size_t frame_encode(const FrameCodec *codec, const GameMessage *msg, uint8_t *out) {
+    if (msg->type == MSG_HELLO_V2) {
+        memcpy(out, PROTO_V2_MAGIC, PROTO_V2_MAGIC_SIZE);
+        out[PROTO_V2_MAGIC_SIZE] = codec->flags;
+        return PROTO_V2_HELLO_SIZE;
+    }
+
+    if (codec->version != 2) {
+        memcpy(out, msg, sizeof(GameMessage));
+        return sizeof(GameMessage);
+    }
+
+    uint8_t *payload = out + PROTO_V2_HEADER_SIZE;
+    size_t n = 0;
+
+    switch (v2_layout(msg->type)) {
+        case V2_CELL:
+            payload[n++] = cell_of(msg->val1, msg->val2);
+            break;
+        case V2_TURN:
+            payload[n++] = cell_of(msg->val1, msg->val2);
+            payload[n++] = (msg->val3 >= 0 && msg->val3 < BOARD_CELLS) ? (uint8_t)msg->val3 : PROTO_V2_NO_CELL;
+            break;
+        case V2_VAL1:
+            payload[n++] = (uint8_t)msg->val1;
+            break;
+        case V2_VAL3:
+            payload[n++] = (uint8_t)msg->val1;
+            payload[n++] = (uint8_t)msg->val2;
+            payload[n++] = (uint8_t)msg->val3;
+            break;
+        case V2_LOGIN:
+        case V2_TEXT:
+            break;
+    }
+
+    if ((codec->flags & PROTO_V2_FLAG_TEXT) || v2_text_is_data(msg->type)) {
+        size_t text_len = strnlen(msg->text, sizeof(msg->text) - 1);
+        memcpy(payload + n, msg->text, text_len);
+        n += text_len;
+    }
+
+    if (v2_layout(msg->type) == V2_LOGIN && msg->val1 > 0 && msg->val1 <= 0xFFFF) {
+        payload[n++] = '\0';
+        payload[n++] = (uint8_t)(msg->val1 & 0xFF);
+        payload[n++] = (uint8_t)(msg->val1 >> 8);
+    }
+
+    out[0] = (uint8_t)msg->type;
+    out[1] = (uint8_t)n;
+    return PROTO_V2_HEADER_SIZE + n;
+}
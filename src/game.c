@@ -6,14 +6,40 @@
 #include <math.h>
 #include "../include/game.h"
 
+// Table des voisins : BB_DILATE d'une case, moins la case elle-même
+#define NB(i) (BB_DILATE(BB_BIT(i)) & ~BB_BIT(i))
+#define NB_ROW(r) NB(r * 8 + 0), NB(r * 8 + 1), NB(r * 8 + 2), NB(r * 8 + 3), \
+                  NB(r * 8 + 4), NB(r * 8 + 5), NB(r * 8 + 6), NB(r * 8 + 7)
+
+const Bitboard game_neighbors[BOARD_CELLS] = {
+    NB_ROW(0), NB_ROW(1), NB_ROW(2), NB_ROW(3), NB_ROW(4), NB_ROW(5)
+};
+
+// Clés Zobrist, elles aussi calculées à la compilation (mélange splitmix64 de l'index)
+#define SM_1(z) (((z) ^ ((z) >> 30)) * 0xBF58476D1CE4E5B9ULL)
+#define SM_2(z) (((z) ^ ((z) >> 27)) * 0x94D049BB133111EBULL)
+#define SM_3(z) ((z) ^ ((z) >> 31))
+#define ZOBRIST(i) SM_3(SM_2(SM_1(((i) + 1) * 0x9E3779B97F4A7C15ULL)))
+#define Z_ROW(base, r) ZOBRIST(base + r * 8 + 0), ZOBRIST(base + r * 8 + 1), \
+                       ZOBRIST(base + r * 8 + 2), ZOBRIST(base + r * 8 + 3), \
+                       ZOBRIST(base + r * 8 + 4), ZOBRIST(base + r * 8 + 5), \
+                       ZOBRIST(base + r * 8 + 6), ZOBRIST(base + r * 8 + 7)
+#define Z_BOARD(base) Z_ROW(base, 0), Z_ROW(base, 1), Z_ROW(base, 2), \
+                      Z_ROW(base, 3), Z_ROW(base, 4), Z_ROW(base, 5)
+
+static const uint64_t zobrist_pawn[2][BOARD_CELLS] = { { Z_BOARD(0) }, { Z_BOARD(48) } };
+static const uint64_t zobrist_destroyed[BOARD_CELLS] = { Z_BOARD(96) };
+#define ZOBRIST_P2_TO_MOVE ZOBRIST(144) // C'est au tour de P2
+#define ZOBRIST_DESTROY    ZOBRIST(145) // Mouvement fait, destruction attendue
+
 // Fonction utilitaire interne : Est-ce qu'on est dans la grille ?
 static int is_inside(int x, int y) {
     return (x >= 0 && x < BOARD_WIDTH && y >= 0 && y < BOARD_HEIGHT);
 }
 
-// Check si la case est une case d'origine
-static int is_origin(int x, int y) {
-    return ((x == 0 && y == 3) || (x == 7 && y == 2));
+// 0 pour P1, 1 pour P2
+static int side_of(const Game *g, const Player *p) {
+    return p == g->p2;
 }
 
 // Initialise une nouvelle partie
@@ -35,92 +61,189 @@ void game_init(Game *g, Player *p1, Player *p2) {
     p2->y = 2;
 
     // 4. Mise à jour du plateau
-    g->board[p1->x][p1->y] = TILE_P1;
-    g->board[p2->x][p2->y] = TILE_P2;
+    g->pos[0] = CELL_INDEX(p1->x, p1->y);
+    g->pos[1] = CELL_INDEX(p2->x, p2->y);
+    g->pawns[0] = BB_BIT(g->pos[0]);
+    g->pawns[1] = BB_BIT(g->pos[1]);
 
     // 5. C'est à P1 de commencer par bouger
     g->current_turn = 1;
     g->phase = PHASE_MOVE;
+    g->hash = game_compute_hash(g);
+}
+
+uint64_t game_compute_hash(const Game *g) {
+    uint64_t h = zobrist_pawn[0][g->pos[0]] ^ zobrist_pawn[1][g->pos[1]];
+
+    Bitboard d = g->destroyed;
+    while (d) {
+        h ^= zobrist_destroyed[__builtin_ctzll(d)];
+        d &= d - 1;
+    }
+    if (g->current_turn == 2) h ^= ZOBRIST_P2_TO_MOVE;
+    if (g->phase == PHASE_DESTROY) h ^= ZOBRIST_DESTROY;
+    return h;
 }
 
 // Vérifie si un mouvement est légal (sans le jouer)
+// Case dans le plateau, libre (ni joueur, ni trou) et adjacente (diagonale comprise)
 int game_check_move(Game *g, Player *p, int dest_x, int dest_y) {
-    // 1. Est-ce dans le plateau ?
     if (!is_inside(dest_x, dest_y)) return 0;
 
-    // 2. Est-ce que la case est libre ? (Ni joueur, ni trou)
-    if (g->board[dest_x][dest_y] != TILE_EMPTY) return 0;
-
-    // 3. Est-ce que c'est une case adjacente (Diagonale comprise) ?
-    // La distance absolue en X et en Y doit être <= 1
-    int diff_x = abs(p->x - dest_x);
-    int diff_y = abs(p->y - dest_y);
-
-    // On ne peut pas rester sur place (0,0) et on ne peut pas sauter (>1)
-    if (diff_x > 1 || diff_y > 1) return 0;
-    if (diff_x == 0 && diff_y == 0) return 0;
-
-    return 1; // Mouvement valide
+    return (int)((game_moves(g, side_of(g, p)) >> CELL_INDEX(dest_x, dest_y)) & 1);
 }
 
 // Applique le mouvement
 void game_apply_move(Game *g, Player *p, int x, int y) {
-    // On vide l'ancienne case
-    g->board[p->x][p->y] = TILE_EMPTY;
+    int side = side_of(g, p);
 
     // On met à jour les coordonnées du joueur
     p->x = x;
     p->y = y;
 
-    // On remplit la nouvelle case (1 ou 2)
-    int player_id = (p == g->p1) ? TILE_P1 : TILE_P2;
-    g->board[x][y] = player_id;
+    // L'ancienne case se vide, la nouvelle se remplit
+    g->hash ^= zobrist_pawn[side][g->pos[side]];
+    g->pos[side] = CELL_INDEX(x, y);
+    g->pawns[side] = BB_BIT(g->pos[side]);
+    g->hash ^= zobrist_pawn[side][g->pos[side]];
 
     // On change la phase : maintenant il doit détruire
     g->phase = PHASE_DESTROY;
+    g->hash ^= ZOBRIST_DESTROY;
 }
 
 // Vérifie si on peut détruire une case
+// Case vide (ni joueur, ni trou) et pas une case d'origine (apparition des joueurs)
 int game_check_destroy(Game *g, Player *p, int x, int y) {
-    // 1. Dans le plateau ?
     if (!is_inside(x, y)) return 0;
 
-    // 2. La case doit être vide (on ne détruit pas un joueur ni une case déjà détruite)
-    if (g->board[x][y] != TILE_EMPTY) return 0;
-
-    // 3. La case ne peut pas être une case d'origine (apparition des joueurs)
-    if (is_origin(x, y)) return 0;
-
-    return 1;
+    return (int)((game_destroyables(g) >> CELL_INDEX(x, y)) & 1);
 }
 
 // Applique la destruction
 void game_apply_destroy(Game *g, int x, int y) {
-    g->board[x][y] = TILE_DESTROYED;
+    g->destroyed |= BB_BIT(CELL_INDEX(x, y));
+    g->hash ^= zobrist_destroyed[CELL_INDEX(x, y)];
 
     // Fin du tour : on passe la main à l'autre joueur
     g->current_turn = (g->current_turn == 1) ? 2 : 1;
     g->phase = PHASE_MOVE;
+    g->hash ^= ZOBRIST_P2_TO_MOVE ^ ZOBRIST_DESTROY;
 }
 
 // Vérifie si le joueur est bloqué (Défaite)
+// Aucune des 8 cases autour de lui n'est libre, ou plus rien à détruire après
+// son mouvement (sinon il pourrait bouger puis rester coincé en phase destruction)
 int game_check_loss(Game *g, Player *p) {
-    // On regarde les 8 cases autour de lui
-    // x de -1 à +1, y de -1 à +1
-    for (int dx = -1; dx <= 1; dx++) {
-        for (int dy = -1; dy <= 1; dy++) {
+    return !game_has_turn(g, side_of(g, p));
+}
 
-            if (dx == 0 && dy == 0) continue; // On ne teste pas sa propre case
+// Vérifie un tour complet sans le jouer
+// La case détruite est testée sur une copie de la partie après le mouvement
+// (l'ancienne case du joueur devient libre, la nouvelle est occupée)
+int game_check_turn(Game *g, Player *p, int x, int y, int destroy_x, int destroy_y) {
+    if (!game_check_move(g, p, x, y)) return 0;
 
-            int tx = p->x + dx;
-            int ty = p->y + dy;
+    Game after = *g;
+    int side = side_of(g, p);
+    after.pos[side] = CELL_INDEX(x, y);
+    after.pawns[side] = BB_BIT(after.pos[side]);
 
-            // Si on trouve UNE case valide (dans le plateau et vide), il n'a pas perdu
-            if (is_inside(tx, ty) && g->board[tx][ty] == TILE_EMPTY) {
-                return 0; // Il peut encore bouger
-            }
+    return game_check_destroy(&after, p, destroy_x, destroy_y);
+}
+
+// Joue un tour complet déjà vérifié
+void game_apply_turn(Game *g, Player *p, int x, int y, int destroy_x, int destroy_y) {
+    game_apply_move(g, p, x, y);
+    game_apply_destroy(g, destroy_x, destroy_y);
+}
+
+// Génère tous les tours (mouvement, destruction) du joueur courant
+// La destruction est prise dans l'état après le mouvement
+int game_gen_turns(const Game *g, Turn *out) {
+    int side = g->current_turn - 1;
+    int n = 0;
+    Bitboard moves = game_moves(g, side);
+
+    while (moves) {
+        int to = __builtin_ctzll(moves);
+        moves &= moves - 1;
+
+        Bitboard occupied = g->destroyed | g->pawns[side ^ 1] | BB_BIT(to);
+        Bitboard destroys = ~occupied & ~BB_ORIGINS & BB_ALL;
+        while (destroys) {
+            out[n].to = (uint8_t)to;
+            out[n].destroy = (uint8_t)__builtin_ctzll(destroys);
+            n++;
+            destroys &= destroys - 1;
         }
     }
-    // Si on a fait le tour et qu'on a rien trouvé : il est bloqué
-    return 1;
-}
\ No newline at end of file
+    return n;
+}
+
+// Tour complet d'un coup (phase PHASE_MOVE avant et après) : seuls changent
+// la case du joueur, une case détruite et le trait
+TurnUndo game_make_turn(Game *g, Turn t) {
+    int side = g->current_turn - 1;
+    TurnUndo u = { g->pos[side], t.to, t.destroy };
+
+    g->hash ^= zobrist_pawn[side][u.from] ^ zobrist_pawn[side][t.to]
+             ^ zobrist_destroyed[t.destroy] ^ ZOBRIST_P2_TO_MOVE;
+    g->pos[side] = t.to;
+    g->pawns[side] = BB_BIT(t.to);
+    g->destroyed |= BB_BIT(t.destroy);
+    g->current_turn ^= 3; // 1 <-> 2
+
+    return u;
+}
+
+void game_unmake_turn(Game *g, TurnUndo u) {
+    g->current_turn ^= 3;
+    int side = g->current_turn - 1;
+
+    g->destroyed &= ~BB_BIT(u.destroy);
+    g->pos[side] = u.from;
+    g->pawns[side] = BB_BIT(u.from);
+    g->hash ^= zobrist_pawn[side][u.from] ^ zobrist_pawn[side][u.to]
+             ^ zobrist_destroyed[u.destroy] ^ ZOBRIST_P2_TO_MOVE;
+}
+
+// Même règle que le serveur : l'adversaire bloqué perd, sinon le joueur qui
+// vient de jouer perd s'il s'est bloqué lui-même
+int game_turn_winner(const Game *g) {
+    int next = g->current_turn - 1; // Celui qui va jouer
+    int mover = next ^ 1;           // Celui qui vient de jouer
+
+    if (!game_has_turn(g, next)) return mover + 1;
+    if (!game_has_turn(g, mover)) return next + 1;
+    return 0;
+}
+
+// Remplissage depuis le pion à travers les cases ni détruites ni occupées
+// (au plus une dilatation par case de chemin, 48 bits traités d'un coup)
+Bitboard game_region(const Game *g, int side) {
+    Bitboard open = ~game_occupied(g) & BB_ALL;
+    Bitboard fill = g->pawns[side];
+    Bitboard prev = 0;
+
+    while (fill != prev) {
+        prev = fill;
+        fill |= BB_DILATE(fill) & open;
+    }
+    return fill & ~g->pawns[side];
+}
+
+int game_separated(const Game *g) {
+    Bitboard reach = game_region(g, 0) | g->pawns[0];
+    return (BB_DILATE(reach) & g->pawns[1]) == 0;
+}
+
+// Contenu d'une case, façon ancien tableau board[x][y]
+int game_tile_at(const Game *g, int x, int y) {
+    Bitboard bit = BB_BIT(CELL_INDEX(x, y));
+
+    if (g->pawns[0] & bit) return TILE_P1;
+    if (g->pawns[1] & bit) return TILE_P2;
+    if (g->destroyed & bit) return TILE_DESTROYED;
+    return TILE_EMPTY;
+}
@@ -0,0 +1,27 @@
+//
+// Histogramme de latences log-linéaire (voir include/histogram.h)
+//
+#include "../include/histogram.h"
+
+uint64_t hist_floor(int c) {
+    if (c < HIST_SUB) return (uint64_t)c;
+    int e = c / HIST_SUB + HIST_SUB_BITS - 1;
+    return ((uint64_t)HIST_SUB + (uint64_t)(c % HIST_SUB)) << (e - HIST_SUB_BITS);
+}
+
+uint64_t hist_quantile(const Histogram *h, double q) {
+    if (h->total == 0) return 0;
+    uint64_t rank = (uint64_t)(q * (double)(h->total - 1)) + 1;
+    uint64_t seen = 0;
+    for (int c = 0; c < HIST_CLASSES; c++) {
+        seen += h->counts[c];
+        if (seen >= rank) return hist_floor(c);
+    }
+    return h->max;
+}
+
+void hist_merge(Histogram *into, const Histogram *h) {
+    for (int c = 0; c < HIST_CLASSES; c++) into->counts[c] += h->counts[c];
+    into->total += h->total;
+    if (h->max > into->max) into->max = h->max;
+}
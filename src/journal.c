@@ -0,0 +1,262 @@
+//
+// Journal des parties : blocs par shard, écriture et fdatasync groupés sur un thread à part
+// (voir include/journal.h)
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "../include/journal.h"
+#include "../include/shard.h"
+#include "../include/log.h"
+
+typedef struct JournalBlock {
+    struct JournalBlock *next;
+    int shard;
+    uint32_t len;
+    uint8_t data[JOURNAL_BLOCK_SIZE];
+} JournalBlock;
+
+// Segment en cours d'un shard (thread du journal seulement)
+typedef struct {
+    int fd;          // -1 tant que le shard n'a rien écrit
+    uint32_t segment;
+    uint64_t bytes;
+    int dirty;       // Écrit depuis le dernier fdatasync
+} JournalFile;
+
+static int journal_enabled = 0;
+static char journal_dir[256];
+static int journal_fsync_ms = 0;
+
+// Blocs remplis, dans l'ordre d'arrivée (une prise de verrou par tour de boucle au plus)
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_cond = PTHREAD_COND_INITIALIZER;
+static JournalBlock *queue_head = NULL;
+static JournalBlock *queue_tail = NULL;
+
+static JournalFile files[MAX_SHARDS];
+
+// Bloc en cours du shard
+static SHARD_LOCAL JournalBlock *current = NULL;
+
+static uint64_t wall_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+// --- Côté shard ---
+
+// Place pour n octets dans le bloc en cours (NULL si plus de mémoire : l'enregistrement est perdu)
+static uint8_t *reserve(size_t n) {
+    if (current != NULL && current->len + n > JOURNAL_BLOCK_SIZE) journal_commit();
+    if (current == NULL) {
+        current = malloc(sizeof(JournalBlock));
+        if (current == NULL) {
+            log_error("Journal : plus de mémoire, enregistrement perdu");
+            return NULL;
+        }
+        current->next = NULL;
+        current->shard = shard_id;
+        current->len = 0;
+    }
+    uint8_t *p = current->data + current->len;
+    current->len += (uint32_t)n;
+    return p;
+}
+
+void journal_start(uint32_t game, const Player *p1, const Player *p2) {
+    if (!journal_enabled) return;
+
+    JournalStart rec;
+    rec.type = JOURNAL_START;
+    rec.game = game;
+    rec.time_ms = wall_ms();
+    rec.rating[0] = (int16_t)p1->rating;
+    rec.rating[1] = (int16_t)p2->rating;
+    rec.name_len[0] = (uint8_t)strnlen(p1->username, sizeof(p1->username));
+    rec.name_len[1] = (uint8_t)strnlen(p2->username, sizeof(p2->username));
+
+    uint8_t *p = reserve(sizeof(rec) + rec.name_len[0] + rec.name_len[1]);
+    if (p == NULL) return;
+    memcpy(p, &rec, sizeof(rec));
+    memcpy(p + sizeof(rec), p1->username, rec.name_len[0]);
+    memcpy(p + sizeof(rec) + rec.name_len[0], p2->username, rec.name_len[1]);
+}
+
+static void put_cell(uint8_t type, uint32_t game, int cell) {
+    if (!journal_enabled) return;
+
+    JournalCell rec = {type, game, (uint8_t)cell};
+    uint8_t *p = reserve(sizeof(rec));
+    if (p != NULL) memcpy(p, &rec, sizeof(rec));
+}
+
+void journal_move(uint32_t game, int cell) {
+    put_cell(JOURNAL_MOVE, game, cell);
+}
+
+void journal_destroy(uint32_t game, int cell) {
+    put_cell(JOURNAL_DESTROY, game, cell);
+}
+
+void journal_turn(uint32_t game, int to, int destroy) {
+    if (!journal_enabled) return;
+
+    JournalTurn rec = {JOURNAL_TURN, game, (uint8_t)to, (uint8_t)destroy};
+    uint8_t *p = reserve(sizeof(rec));
+    if (p != NULL) memcpy(p, &rec, sizeof(rec));
+}
+
+void journal_end(uint32_t game, int winner, int reason) {
+    if (!journal_enabled) return;
+
+    JournalEnd rec = {JOURNAL_END, game, (uint8_t)winner, (uint8_t)reason, wall_ms()};
+    uint8_t *p = reserve(sizeof(rec));
+    if (p != NULL) memcpy(p, &rec, sizeof(rec));
+}
+
+void journal_commit(void) {
+    if (current == NULL || current->len == 0) return;
+
+    pthread_mutex_lock(&queue_lock);
+    if (queue_tail) queue_tail->next = current;
+    else queue_head = current;
+    queue_tail = current;
+    pthread_cond_signal(&queue_cond);
+    pthread_mutex_unlock(&queue_lock);
+    current = NULL;
+}
+
+// --- Thread du journal ---
+
+static int write_all(int fd, const uint8_t *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Ouvre le segment suivant du shard (sans jamais écraser un segment existant)
+static int open_segment(int shard) {
+    JournalFile *f = &files[shard];
+    char path[320];
+    while (1) {
+        snprintf(path, sizeof(path), "%s/shard%d-%06u.isj", journal_dir, shard, f->segment);
+        f->fd = open(path, O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0644);
+        if (f->fd >= 0) break;
+        if (errno != EEXIST) {
+            log_error("Journal : ouverture de %s impossible : %s", path, strerror(errno));
+            return -1;
+        }
+        f->segment++;
+    }
+
+    JournalHeader h;
+    memcpy(h.magic, JOURNAL_MAGIC, 4);
+    h.version = JOURNAL_VERSION;
+    h.shard = (uint16_t)shard;
+    h.created_ms = wall_ms();
+    if (write_all(f->fd, (const uint8_t *)&h, sizeof(h)) < 0) return -1;
+    f->bytes = sizeof(h);
+    f->dirty = 1;
+    log_info("Journal : segment %s", path);
+    return 0;
+}
+
+static void sync_file(JournalFile *f) {
+    if (f->fd >= 0 && f->dirty && fdatasync(f->fd) < 0) log_error("Journal : fdatasync : %s", strerror(errno));
+    f->dirty = 0;
+}
+
+static void write_block(JournalBlock *b) {
+    JournalFile *f = &files[b->shard];
+    if (f->fd >= 0 && f->bytes >= JOURNAL_SEGMENT_BYTES) {
+        sync_file(f);
+        close(f->fd);
+        f->fd = -1;
+        f->segment++;
+    }
+    if (f->fd < 0 && open_segment(b->shard) < 0) return;
+
+    if (write_all(f->fd, b->data, b->len) < 0) {
+        log_error("Journal : écriture (shard %d) : %s", b->shard, strerror(errno));
+        return;
+    }
+    f->bytes += b->len;
+    f->dirty = 1;
+}
+
+static void *journal_thread(void *arg) {
+    (void)arg;
+    uint64_t next_sync = 0;
+    int dirty = 0;
+
+    while (1) {
+        // Attente de blocs, ou de l'heure du prochain fdatasync s'il y a des écritures à couvrir
+        pthread_mutex_lock(&queue_lock);
+        while (queue_head == NULL) {
+            if (!dirty) {
+                pthread_cond_wait(&queue_cond, &queue_lock);
+                continue;
+            }
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            uint64_t now = wall_ms();
+            if (now >= next_sync) break;
+            uint64_t wait_ns = (next_sync - now) * 1000000ULL + (uint64_t)deadline.tv_nsec;
+            deadline.tv_sec += (time_t)(wait_ns / 1000000000ULL);
+            deadline.tv_nsec = (long)(wait_ns % 1000000000ULL);
+            pthread_cond_timedwait(&queue_cond, &queue_lock, &deadline);
+        }
+        JournalBlock *b = queue_head;
+        queue_head = queue_tail = NULL;
+        pthread_mutex_unlock(&queue_lock);
+
+        // Tout le lot d'un coup, puis un seul fdatasync par fichier (commit groupé)
+        while (b) {
+            JournalBlock *next = b->next;
+            write_block(b);
+            free(b);
+            b = next;
+            dirty = 1;
+        }
+
+        uint64_t now = wall_ms();
+        if (!dirty || (journal_fsync_ms > 0 && now < next_sync)) continue;
+        for (int i = 0; i < MAX_SHARDS; i++) sync_file(&files[i]);
+        dirty = 0;
+        next_sync = now + (uint64_t)journal_fsync_ms;
+    }
+    return NULL;
+}
+
+int journal_open(const char *dir, int fsync_ms) {
+    if (strlen(dir) >= sizeof(journal_dir)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    if (mkdir(dir, 0755) < 0 && errno != EEXIST) return -1;
+
+    strcpy(journal_dir, dir);
+    journal_fsync_ms = (fsync_ms < 0) ? 0 : fsync_ms;
+    for (int i = 0; i < MAX_SHARDS; i++) files[i].fd = -1;
+
+    pthread_t t;
+    if (pthread_create(&t, NULL, journal_thread, NULL) != 0) return -1;
+    pthread_detach(t);
+    journal_enabled = 1;
+    return 0;
+}
@@ -0,0 +1,381 @@
+//
+// Journal asynchrone : anneaux par thread, formatage sur un thread à part (voir include/log.h)
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <time.h>
+#include "../include/log.h"
+#include "../include/shard.h"
+
+atomic_int log_level = LOG_INFO;
+
+// Enregistrement : en-tête puis arguments bruts, 8 octets par nombre,
+// chaînes recopiées avec leur '\0'
+#define LOG_HEADER_SIZE (sizeof(uint64_t) + sizeof(const char *) + 4)
+#define LOG_DATA_SIZE (LOG_RECORD_SIZE - LOG_HEADER_SIZE)
+
+typedef struct {
+    uint64_t time_ns;   // CLOCK_REALTIME
+    const char *fmt;
+    uint8_t level;
+    uint8_t truncated;  // Arguments manquants (plus de place)
+    uint16_t data_len;
+    uint8_t data[LOG_DATA_SIZE];
+} LogRecord;
+
+_Static_assert(sizeof(LogRecord) == LOG_RECORD_SIZE, "LogRecord doit faire LOG_RECORD_SIZE octets");
+
+// Anneau d'un thread : head avancé par le thread, tail par le thread du journal
+// (chacun sur sa ligne de cache)
+typedef struct {
+    _Alignas(64) atomic_uint_fast64_t head;
+    _Alignas(64) atomic_uint_fast64_t tail;
+    _Alignas(64) atomic_uint_fast64_t dropped; // Écrit par le thread seulement
+    uint64_t dropped_seen;                     // Déjà signalé (thread du journal)
+    int shard;                                 // Shard du thread à la création de l'anneau
+    LogRecord records[LOG_RING_RECORDS];
+} LogRing;
+
+static _Atomic(LogRing *) rings[LOG_MAX_RINGS];
+static atomic_int ring_count = 0;
+static _Thread_local LogRing *my_ring = NULL;
+static _Thread_local int my_ring_failed = 0;
+
+// Un seul consommateur à la fois (thread du journal ou log_flush)
+static pthread_mutex_t drain_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *level_names[] = {"ERREUR", "ALERTE", "INFO", "DEBUG"};
+
+// --- Côté producteur ---
+
+static LogRing *ring_of_thread(void) {
+    if (my_ring != NULL || my_ring_failed) return my_ring;
+
+    int idx = atomic_fetch_add(&ring_count, 1);
+    LogRing *r = (idx < LOG_MAX_RINGS) ? aligned_alloc(64, sizeof(LogRing)) : NULL;
+    if (r == NULL) {
+        my_ring_failed = 1;
+        return NULL;
+    }
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    atomic_init(&r->dropped, 0);
+    r->dropped_seen = 0;
+    r->shard = shard_id;
+    atomic_store_explicit(&rings[idx], r, memory_order_release);
+    my_ring = r;
+    return r;
+}
+
+static int put_bytes(LogRecord *rec, const void *src, size_t n) {
+    if (rec->data_len + n > LOG_DATA_SIZE) {
+        rec->truncated = 1;
+        return -1;
+    }
+    memcpy(rec->data + rec->data_len, src, n);
+    rec->data_len += (uint16_t)n;
+    return 0;
+}
+
+static int put_u64(LogRecord *rec, uint64_t v) {
+    return put_bytes(rec, &v, sizeof(v));
+}
+
+// Chaîne tronquée s'il le faut, toujours terminée par '\0'
+static int put_string(LogRecord *rec, const char *s) {
+    if (s == NULL) s = "(null)";
+    size_t room = LOG_DATA_SIZE - rec->data_len;
+    if (room == 0) {
+        rec->truncated = 1;
+        return -1;
+    }
+    size_t n = strnlen(s, room - 1);
+    memcpy(rec->data + rec->data_len, s, n);
+    rec->data[rec->data_len + n] = '\0';
+    rec->data_len += (uint16_t)(n + 1);
+    return 0;
+}
+
+// Une conversion du format : drapeaux, largeur, précision, longueur, type
+typedef struct {
+    const char *start; // Sur le '%'
+    const char *end;   // Après le caractère de conversion
+    int star_width, star_precision;
+    int length;        // 0 (int), 1 (long), 2 (long long), 3 (size_t / intmax_t / ptrdiff_t)
+    char conv;
+} FmtSpec;
+
+// Cherche la prochaine conversion à partir de p (NULL s'il n'y en a plus), "%%" compris
+static const char *next_spec(const char *p, FmtSpec *s) {
+    while (*p && *p != '%') p++;
+    if (*p == '\0') return NULL;
+
+    memset(s, 0, sizeof(*s));
+    s->start = p++;
+    while (*p && strchr("-+ #0'", *p)) p++;
+    if (*p == '*') {
+        s->star_width = 1;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9') p++;
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            s->star_precision = 1;
+            p++;
+        }
+        while (*p >= '0' && *p <= '9') p++;
+    }
+    if (*p == 'h') {
+        p++;
+        if (*p == 'h') p++;
+    } else if (*p == 'l') {
+        s->length = 1;
+        p++;
+        if (*p == 'l') {
+            s->length = 2;
+            p++;
+        }
+    } else if (*p == 'z' || *p == 'j' || *p == 't') {
+        s->length = 3;
+        p++;
+    } else if (*p == 'L') {
+        p++;
+    }
+    s->conv = *p;
+    if (*p) p++;
+    s->end = p;
+    return p;
+}
+
+static uint64_t arg_integer(va_list *ap, int length) {
+    switch (length) {
+        case 1: return (uint64_t)va_arg(*ap, long);
+        case 2: return (uint64_t)va_arg(*ap, long long);
+        case 3: return (uint64_t)va_arg(*ap, size_t);
+        default: return (uint64_t)(int64_t)va_arg(*ap, int);
+    }
+}
+
+void log_write(int level, const char *fmt, ...) {
+    LogRing *r = ring_of_thread();
+    if (r == NULL) return;
+
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+    if (head - tail >= LOG_RING_RECORDS) {
+        atomic_store_explicit(&r->dropped, atomic_load_explicit(&r->dropped, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+        return;
+    }
+
+    LogRecord *rec = &r->records[head & (LOG_RING_RECORDS - 1)];
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    rec->time_ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    rec->fmt = fmt;
+    rec->level = (uint8_t)level;
+    rec->truncated = 0;
+    rec->data_len = 0;
+
+    // Copie brute des arguments, dans l'ordre des conversions
+    va_list ap;
+    va_start(ap, fmt);
+    FmtSpec s;
+    const char *p = fmt;
+    int full = 0;
+    while (!full && (p = next_spec(p, &s)) != NULL) {
+        if (s.star_width) full |= put_u64(rec, (uint64_t)(int64_t)va_arg(ap, int));
+        if (s.star_precision) full |= put_u64(rec, (uint64_t)(int64_t)va_arg(ap, int));
+        switch (s.conv) {
+            case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+                full |= put_u64(rec, arg_integer(&ap, s.length));
+                break;
+            case 'f': case 'F': case 'g': case 'G': case 'e': case 'E': {
+                double d = va_arg(ap, double);
+                full |= put_bytes(rec, &d, sizeof(d));
+                break;
+            }
+            case 's':
+                full |= put_string(rec, va_arg(ap, const char *));
+                break;
+            case 'p':
+                full |= put_u64(rec, (uint64_t)(uintptr_t)va_arg(ap, void *));
+                break;
+            default: // "%%" ou conversion inconnue : pas d'argument
+                break;
+        }
+    }
+    va_end(ap);
+
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+}
+
+// --- Côté thread du journal ---
+
+static uint64_t get_u64(const LogRecord *rec, size_t *off) {
+    uint64_t v = 0;
+    if (*off + sizeof(v) <= rec->data_len) memcpy(&v, rec->data + *off, sizeof(v));
+    *off += sizeof(v);
+    return v;
+}
+
+// Le morceau de format d'une conversion, avec les '*' remplacés par leur valeur
+static void spec_text(const FmtSpec *s, char *out, size_t size, int width, int precision) {
+    size_t len = 0;
+    for (const char *c = s->start; c < s->end && len + 12 < size; c++) {
+        if (*c == '*') {
+            int v = (c > s->start && c[-1] == '.') ? precision : width;
+            len += (size_t)snprintf(out + len, size - len, "%d", v);
+        } else {
+            out[len++] = *c;
+        }
+    }
+    out[len] = '\0';
+}
+
+// Remet en forme un enregistrement, comme l'aurait fait printf au moment de l'appel
+static void format_record(FILE *out, const LogRing *r, const LogRecord *rec) {
+    time_t secs = (time_t)(rec->time_ns / 1000000000ULL);
+    struct tm tm;
+    char stamp[16];
+    localtime_r(&secs, &tm);
+    strftime(stamp, sizeof(stamp), "%H:%M:%S", &tm);
+    fprintf(out, "%s.%03u %-6s [%d] ", stamp, (unsigned)(rec->time_ns / 1000000 % 1000),
+            level_names[rec->level], r->shard);
+
+    const char *p = rec->fmt;
+    size_t off = 0;
+    FmtSpec s;
+    const char *next;
+    while ((next = next_spec(p, &s)) != NULL) {
+        fwrite(p, 1, (size_t)(s.start - p), out);
+        p = next;
+        if (s.conv == '%') {
+            fputc('%', out);
+            continue;
+        }
+        if (off >= rec->data_len) {
+            fputs("...", out); // Argument perdu (enregistrement plein)
+            continue;
+        }
+
+        int width = s.star_width ? (int)(int64_t)get_u64(rec, &off) : 0;
+        int precision = s.star_precision ? (int)(int64_t)get_u64(rec, &off) : 0;
+        char spec[48];
+        spec_text(&s, spec, sizeof(spec), width, precision);
+
+        // Un seul argument, du type qu'attend la conversion
+        switch (s.conv) {
+            case 'd': case 'i': case 'c': {
+                uint64_t v = get_u64(rec, &off);
+                if (s.length == 0) fprintf(out, spec, (int)(int64_t)v);
+                else if (s.length == 1) fprintf(out, spec, (long)v);
+                else if (s.length == 2) fprintf(out, spec, (long long)v);
+                else fprintf(out, spec, (ptrdiff_t)v);
+                break;
+            }
+            case 'u': case 'x': case 'X': case 'o': {
+                uint64_t v = get_u64(rec, &off);
+                if (s.length == 0) fprintf(out, spec, (unsigned)v);
+                else if (s.length == 1) fprintf(out, spec, (unsigned long)v);
+                else if (s.length == 2) fprintf(out, spec, (unsigned long long)v);
+                else fprintf(out, spec, (size_t)v);
+                break;
+            }
+            case 'f': case 'F': case 'g': case 'G': case 'e': case 'E': {
+                double d = 0;
+                if (off + sizeof(d) <= rec->data_len) memcpy(&d, rec->data + off, sizeof(d));
+                off += sizeof(d);
+                fprintf(out, spec, d);
+                break;
+            }
+            case 's': {
+                const char *str = (const char *)rec->data + off;
+                off += strlen(str) + 1;
+                fprintf(out, spec, str);
+                break;
+            }
+            case 'p':
+                fprintf(out, spec, (void *)(uintptr_t)get_u64(rec, &off));
+                break;
+            default:
+                fwrite(s.start, 1, (size_t)(s.end - s.start), out);
+                break;
+        }
+    }
+    fputs(p, out);
+    if (rec->truncated) fputs(" [tronqué]", out);
+    fputc('\n', out);
+}
+
+// Vide tous les anneaux une fois. Renvoie le nombre d'enregistrements écrits
+static uint64_t drain(FILE *out) {
+    uint64_t written = 0;
+    int count = atomic_load(&ring_count);
+    if (count > LOG_MAX_RINGS) count = LOG_MAX_RINGS;
+
+    pthread_mutex_lock(&drain_lock);
+    for (int i = 0; i < count; i++) {
+        LogRing *r = atomic_load_explicit(&rings[i], memory_order_acquire);
+        if (r == NULL) continue;
+
+        uint64_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+        uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+        for (; tail != head; tail++) {
+            format_record(out, r, &r->records[tail & (LOG_RING_RECORDS - 1)]);
+            written++;
+        }
+        atomic_store_explicit(&r->tail, tail, memory_order_release);
+
+        uint64_t dropped = atomic_load_explicit(&r->dropped, memory_order_relaxed);
+        if (dropped != r->dropped_seen) {
+            fprintf(out, "%-6s [%d] %lu messages perdus (journal plein)\n", level_names[LOG_WARN], r->shard,
+                    (unsigned long)(dropped - r->dropped_seen));
+            r->dropped_seen = dropped;
+        }
+    }
+    if (written) fflush(out);
+    pthread_mutex_unlock(&drain_lock);
+    return written;
+}
+
+static void *log_thread(void *arg) {
+    (void)arg;
+    const struct timespec idle = {0, LOG_IDLE_MS * 1000000L};
+    while (1) {
+        if (drain(stdout) == 0) nanosleep(&idle, NULL);
+    }
+    return NULL;
+}
+
+int log_start(void) {
+    pthread_t t;
+    if (pthread_create(&t, NULL, log_thread, NULL) != 0) return -1;
+    pthread_detach(t);
+    atexit(log_flush);
+    return 0;
+}
+
+void log_flush(void) {
+    drain(stdout);
+}
+
+int log_parse_level(const char *name) {
+    for (int i = 0; i <= LOG_DEBUG; i++) {
+        if (strcasecmp(name, level_names[i]) == 0) return i;
+    }
+    if (name[0] >= '0' && name[0] <= '0' + LOG_DEBUG && name[1] == '\0') return name[0] - '0';
+    return -1;
+}
+
+void log_on_signal(int sig) {
+    (void)sig;
+    int level = atomic_load_explicit(&log_level, memory_order_relaxed);
+    atomic_store_explicit(&log_level, (level >= LOG_DEBUG) ? LOG_ERROR : level + 1, memory_order_relaxed);
+}
@@ -1,59 +1,180 @@
 #include <stdio.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/socket.h>
+#include <sys/resource.h>
 #include <arpa/inet.h>
-#include <poll.h>
 #include <errno.h>
+#include <time.h>
+#include <math.h>
+#include <signal.h>
+#include <stdatomic.h>
 
 // Inclusion des headers du projet
 #include "../include/config.h"
 #include "../include/protocol.h"
 #include "../include/game.h"
+#include "../include/net.h"
+#include "../include/framing.h"
+#include "../include/shard.h"
+#include "../include/bot.h"
+#include "../include/tt.h"
+#include "../include/solver.h"
+#include "../include/book.h"
+#include "../include/matchmaking.h"
+#include "../include/pool.h"
+#include "../include/timer.h"
+#include "../include/metrics.h"
+#include "../include/log.h"
+#include "../include/journal.h"
 
 // --- VARIABLES GLOBALES ---
+// Tout ce qui est SHARD_LOCAL existe une fois par thread (voir shard.h)
 
-// Tableau de tous les joueurs potentiels
-Player clients[MAX_CLIENTS];
+// Un client = sa connexion réseau + son joueur, alloués ensemble
+typedef struct {
+    uint32_t pool_next; // Réservé au pool (liste libre)
+    Connection conn;
+    Player player;
+} ClientSlot;
 
-// Tableau pour poll() : gère les sockets ouverts
-struct pollfd fds[MAX_CLIENTS + 1];
-int nfds = 0; // Nombre de sockets surveillés
+// Une partie et le joueur bot qui y joue peut-être
+typedef struct {
+    uint32_t pool_next; // Réservé au pool (liste libre)
+    uint32_t id;        // Numéro dans le pool, donné au bot (Handoff.bot.game_id)
+    uint32_t bot_seq;   // Numéro de la dernière demande au bot (survit au recyclage du slot)
+    Timer turn_clock;   // Temps laissé au joueur dont c'est le tour (TURN_TIMEOUT_MS)
+    Game game;
+    Player bot;
+} GameSlot;
 
-// Tableau des parties en cours
-// (Si on a 100 clients max, on peut avoir max 50 parties)
-Game games[MAX_CLIENTS / 2];
+// Capacité de chaque shard (option -c) : les pools grandissent jusque-là à la demande
+int max_clients = MAX_CLIENTS;
 
-// Pointeur vers le joueur qui attend actuellement dans le lobby
-Player *waiting_player = NULL;
+// Option -r : en fin de partie, les joueurs retournent directement dans la file
+int auto_requeue = 0;
+
+// Port des stats en texte sur 127.0.0.1 (option -s, 0 = aucun)
+int stats_port = STATS_PORT;
+
+// Tous les clients et toutes les parties du shard (voir pool.h)
+SHARD_LOCAL Pool client_pool;
+SHARD_LOCAL Pool game_pool;
+
+// Index fd -> connexion (alloué au démarrage, une entrée par fd possible)
+// Partagé entre shards : un fd fermé peut être aussitôt réattribué par accept() sur un autre
+// shard, d'où des entrées atomiques (voir index_fd / unindex_fd)
+_Atomic(Connection *) *conn_by_fd = NULL;
+int conn_by_fd_size = 0;
+
+// Connexions avec des messages en attente (ou à fermer), vidées en fin de tour de boucle
+// (liste chaînée par Connection.pending_next, dans l'ordre d'arrivée)
+SHARD_LOCAL Connection *pending_head = NULL;
+SHARD_LOCAL Connection *pending_tail = NULL;
+
+// Prochain passage du matchmaking (les joueurs en attente sont dans matchmaking.c)
+SHARD_LOCAL uint64_t next_mm_tick = 0;
+
+// Début du tour de boucle en cours (fin de l'attente du backend), pour metrics->loop_ns
+SHARD_LOCAL uint64_t loop_started_ns = 0;
 
 
 // --- FONCTIONS UTILITAIRES ---
 
 // Trouve la partie associée à un joueur
 Game* find_game_of_player(Player *p) {
-    for (int i = 0; i < MAX_CLIENTS / 2; i++) {
-        if (games[i].p1 == p || games[i].p2 == p) {
-            return &games[i];
-        }
-    }
-    return NULL;
+    return p->game;
+}
+
+// Slot d'une partie (la partie est un champ du slot)
+GameSlot *game_slot(Game *g) {
+    return (GameSlot *)((uint8_t *)g - offsetof(GameSlot, game));
 }
 
 // Trouve un emplacement mémoire libre pour créer une partie
 Game* create_game_slot() {
-    for (int i = 0; i < MAX_CLIENTS / 2; i++) {
-        // On considère qu'une partie est vide si p1 est NULL
-        if (games[i].p1 == NULL) {
-            return &games[i];
+    uint32_t id = pool_alloc(&game_pool);
+    if (id == POOL_NONE) return NULL;
+
+    GameSlot *slot = pool_at(&game_pool, id);
+    slot->id = id;
+    return &slot->game;
+}
+
+// Horloge monotone en millisecondes
+uint64_t now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+Connection *conn_from_fd(int fd) {
+    if (fd < 0 || fd >= conn_by_fd_size) return NULL;
+    return atomic_load_explicit(&conn_by_fd[fd], memory_order_acquire);
+}
+
+// Publie la connexion sous son fd (release : le slot est rempli avant d'être visible)
+void index_fd(Connection *c) {
+    atomic_store_explicit(&conn_by_fd[c->fd], c, memory_order_release);
+}
+
+// Retire le fd de l'index, seulement s'il désigne encore c
+// A faire avant close() : après, le fd peut déjà appartenir à une connexion d'un autre shard
+void unindex_fd(Connection *c) {
+    Connection *expected = c;
+    atomic_compare_exchange_strong_explicit(&conn_by_fd[c->fd], &expected, NULL,
+                                            memory_order_release, memory_order_relaxed);
+}
+
+// Prépare la table fd -> connexion (commune à tous les shards)
+// La limite de fd ouverts est d'abord montée (dans la limite dure) pour la capacité demandée
+void init_fd_index() {
+    struct rlimit rl;
+    conn_by_fd_size = 1024;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        rlim_t wanted = (rlim_t)max_clients * (rlim_t)shard_count + 64;
+        if (rl.rlim_cur != RLIM_INFINITY && rl.rlim_cur < wanted) {
+            rl.rlim_cur = (rl.rlim_max == RLIM_INFINITY || rl.rlim_max > wanted) ? wanted : rl.rlim_max;
+            if (setrlimit(RLIMIT_NOFILE, &rl) < 0) getrlimit(RLIMIT_NOFILE, &rl);
         }
+        if (rl.rlim_cur != RLIM_INFINITY) conn_by_fd_size = (int)rl.rlim_cur;
+    }
+
+    conn_by_fd = calloc(conn_by_fd_size, sizeof(*conn_by_fd));
+    if (conn_by_fd == NULL) {
+        perror("Echec allocation index fd");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Prépare les pools du shard courant (rien n'est alloué avant le premier client)
+// Une partie a toujours au moins un humain : autant de parties que de clients au plus
+void init_pools() {
+    if (pool_init(&client_pool, sizeof(ClientSlot), POOL_CHUNK_CLIENTS, (uint32_t)max_clients) < 0 ||
+        pool_init(&game_pool, sizeof(GameSlot), POOL_CHUNK_GAMES, (uint32_t)max_clients) < 0) {
+        perror("Echec allocation pools");
+        exit(EXIT_FAILURE);
     }
-    return NULL;
+}
+
+// Note la connexion pour la fin du tour de boucle (envoi groupé ou fermeture)
+void mark_pending(Connection *c) {
+    if (c->tx_dirty) return;
+    c->tx_dirty = 1;
+    c->pending_next = NULL;
+    if (pending_tail) pending_tail->pending_next = c;
+    else pending_head = c;
+    pending_tail = c;
 }
 
 // Helper pour envoyer un message structuré
+// Le message est seulement mis en file : l'envoi réel se fait dans flush_pending()
 void send_msg(int socket, int type, int v1, int v2, int v3, const char *text) {
+    Connection *c = conn_from_fd(socket);
+    if (c == NULL || c->closing) return;
+
     GameMessage msg;
     memset(&msg, 0, sizeof(msg));
     msg.type = type;
@@ -62,8 +183,61 @@ void send_msg(int socket, int type, int v1, int v2, int v3, const char *text) {
     msg.val3 = v3;
     if (text) strncpy(msg.text, text, 63);
 
-    if (send(socket, &msg, sizeof(msg), 0) < 0) {
-        perror("Erreur send_msg");
+    uint8_t frame[FRAME_MAX_SIZE];
+    uint32_t n = (uint32_t)frame_encode(&c->codec, &msg, frame);
+
+    // File pleine : le client ne lit plus, on le coupe
+    if (c->tx_len + n > CONN_TX_SIZE) {
+        log_warn("Client trop lent (Socket %d), déconnexion.", socket);
+        c->closing = 1;
+        mark_pending(c);
+        return;
+    }
+
+    // Copie dans l'anneau, en deux morceaux si on passe la fin
+    uint32_t tail = (c->tx_head + c->tx_len) % CONN_TX_SIZE;
+    uint32_t first = CONN_TX_SIZE - tail;
+    if (first > n) first = n;
+    memcpy(c->tx + tail, frame, first);
+    memcpy(c->tx, frame + first, n - first);
+    c->tx_len += n;
+    metrics->msg_out[metrics_type(type)]++;
+    metrics->bytes_out += n;
+
+    mark_pending(c);
+}
+
+void handle_disconnect(Connection *c);
+
+// Connexion restée muette trop longtemps (pas de login, ou plus rien reçu) : on la ferme
+void on_idle_timeout(Timer *t) {
+    Connection *c = TIMER_OWNER(t, Connection, idle);
+    log_warn("Inactivité (Socket %d), déconnexion.", c->fd);
+    c->closing = 1;
+    mark_pending(c);
+}
+
+// Activité sur la connexion : le délai repart (court tant que le joueur ne s'est pas identifié)
+void arm_idle_timer(Connection *c) {
+    uint64_t delay = c->player->username[0] ? IDLE_TIMEOUT_MS : LOGIN_TIMEOUT_MS;
+    timer_arm(&c->idle, now_ms() + delay, on_idle_timeout);
+}
+
+// Fin de tour de boucle : envois groupés et fermetures différées
+void flush_pending() {
+    // handle_disconnect() peut en ajouter d'autres : ils sont pris en fin de liste
+    while (pending_head) {
+        Connection *c = pending_head;
+        pending_head = c->pending_next;
+        if (pending_head == NULL) pending_tail = NULL;
+        c->tx_dirty = 0;
+        if (c->fd == 0) {
+            pool_free(&client_pool, c->slot); // Libérée pendant le tour (voir release_slot)
+            continue;
+        }
+
+        if (!c->closing && net_flush(c) < 0) c->closing = 1;
+        if (c->closing) handle_disconnect(c);
     }
 }
 
@@ -80,7 +254,9 @@ int setup_server_socket() {
     }
 
     // 2. Options (Reuse address pour éviter l'erreur "Address already in use")
-    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt))) {
+    // SO_REUSEPORT : chaque shard a son propre socket sur le même port, le noyau répartit
+    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) ||
+        setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt))) {
         perror("Echec setsockopt");
         exit(EXIT_FAILURE);
     }
@@ -95,295 +271,837 @@ int setup_server_socket() {
         exit(EXIT_FAILURE);
     }
 
-    // 4. Listen
-    if (listen(server_fd, 10) < 0) {
+    // 4. Listen (file d'attente du noyau au maximum : arrivées en rafale)
+    if (listen(server_fd, SOMAXCONN) < 0) {
         perror("Echec listen");
         exit(EXIT_FAILURE);
     }
 
-    printf("--- SERVEUR ISOLA DÉMARRÉ SUR LE PORT %d ---\n", PORT);
+    // 5. Non bloquant : on accepte en boucle jusqu'à EAGAIN
+    if (net_set_nonblocking(server_fd) < 0) {
+        perror("Echec fcntl");
+        exit(EXIT_FAILURE);
+    }
+
+    if (shard_id == 0) {
+        log_info("--- SERVEUR ISOLA DÉMARRÉ SUR LE PORT %d (%s, %d thread(s)) ---",
+               PORT, net_backend_name(), shard_count);
+    }
     return server_fd;
 }
 
 // --- LOGIQUE DE JEU ET MATCHMAKING ---
 
+// Le joueur entre dans la file : les paires sont formées par lots au prochain tick (server_tick)
 void attempt_matchmaking(Player *p) {
-    // Protection : Si le joueur est déjà en jeu, on ne fait rien
-    if (p->state == STATE_INGAME) return;
+    // Protection : Si le joueur est déjà en jeu ou en file, on ne fait rien
+    if (p->state == STATE_INGAME || p->queued) return;
+
+    log_debug("[MATCHMAKING] Demande de %s (cote %d)...", p->username, p->rating);
+
+    mm_enqueue(p, now_ms());
+    p->state = STATE_LOBBY;
+
+    log_debug("-> Mis en file d'attente (%d joueurs).", mm_size());
+    send_msg(p->socket, RES_LOGIN_OK, 0, 0, 0, "En attente d'un adversaire...");
+}
+
+void release_game(Game *g);
+
+// Le joueur dont c'est le tour a laissé filer son temps : il perd la partie
+void on_turn_timeout(Timer *t) {
+    Game *g = &TIMER_OWNER(t, GameSlot, turn_clock)->game;
+    Player *late = (g->current_turn == 1) ? g->p1 : g->p2;
+    Player *opp = (late == g->p1) ? g->p2 : g->p1;
+
+    g->winner = (late == g->p1) ? 2 : 1;
+    log_info("-> Partie %d : temps écoulé pour %s, gagnant : P%d", g->id, late->username, g->winner);
+    journal_end((uint32_t)g->id, g->winner, JOURNAL_END_TIMEOUT);
+    send_msg(late->socket, NOTIF_GAME_OVER, g->winner, 0, 0, "DÉFAITE (temps écoulé)");
+    send_msg(opp->socket, NOTIF_GAME_OVER, g->winner, 0, 0, "VICTOIRE (temps écoulé)");
+    release_game(g);
+}
 
-    printf("[MATCHMAKING] Demande de %s...\n", p->username);
+// Nouveau tour : la pendule repart pour le joueur qui doit jouer (le bot n'en a pas)
+void start_turn_clock(Game *g) {
+    Timer *clock = &game_slot(g)->turn_clock;
+    Player *p = (g->current_turn == 1) ? g->p1 : g->p2;
+    if (p->socket == BOT_SOCKET) timer_cancel(clock);
+    else timer_arm(clock, now_ms() + TURN_TIMEOUT_MS, on_turn_timeout);
+}
+
+// Crée la partie de deux joueurs sortis de la file (a joue en premier)
+// Renvoie 0 s'il n'y a plus de slot de partie libre
+int start_game(Player *a, Player *b) {
+    Game *new_game = create_game_slot();
+    if (new_game == NULL) return 0;
+
+    // Init de la partie (via src/game.c)
+    game_init(new_game, a, b);
+    new_game->id = (int)game_slot(new_game)->id;
+    a->game = new_game;
+    b->game = new_game;
+
+    // Mise à jour des états
+    a->state = STATE_INGAME;
+    b->state = STATE_INGAME;
+    a->queued_at = 0;
+    b->queued_at = 0;
+
+    log_info("-> PARTIE LANCÉE : %s (P1, %d) vs %s (P2, %d)", a->username, a->rating, b->username, b->rating);
+    journal_start((uint32_t)new_game->id, a, b);
+
+    // val1 = ID Joueur (1 ou 2), val2 = Largeur, val3 = Hauteur
+    send_msg(a->socket, NOTIF_GAME_START, 1, BOARD_WIDTH, BOARD_HEIGHT, b->username);
+    send_msg(b->socket, NOTIF_GAME_START, 2, BOARD_WIDTH, BOARD_HEIGHT, a->username);
+    start_turn_clock(new_game);
+    return 1;
+}
+
+// Personne n'est venu : le joueur en attente affronte le bot (il joue en premier)
+// Renvoie 0 s'il n'y a plus de slot de partie libre
+int start_bot_game(Player *p) {
+    Game *new_game = create_game_slot();
+    if (new_game == NULL) return 0;
+
+    GameSlot *slot = game_slot(new_game);
+    Player *bot = &slot->bot;
+    memset(bot, 0, sizeof(Player));
+    bot->socket = BOT_SOCKET;
+    bot->state = STATE_INGAME;
+    bot->rating = BOT_RATING;
+    strcpy(bot->username, BOT_NAME);
+
+    game_init(new_game, p, bot);
+    new_game->id = (int)slot->id;
+    p->game = new_game;
+    bot->game = new_game;
+    p->state = STATE_INGAME;
+    p->queued_at = 0;
+
+    log_info("-> PARTIE LANCÉE : %s (P1) vs %s (bot)", p->username, bot->username);
+    journal_start((uint32_t)new_game->id, p, bot);
+    send_msg(p->socket, NOTIF_GAME_START, 1, BOARD_WIDTH, BOARD_HEIGHT, bot->username);
+    start_turn_clock(new_game);
+    return 1;
+}
+
+// Si c'est au bot de jouer, on lance sa recherche (réponse dans on_wakeup)
+void request_bot_turn(Game *g) {
+    if (g->winner != 0) return;
+    Player *p = (g->current_turn == 1) ? g->p1 : g->p2;
+    if (p->socket != BOT_SOCKET) return;
+    bot_request(shard_id, g->id, ++game_slot(g)->bot_seq, g);
+}
+
+// Elo : le vainqueur prend K * (1 - probabilité qu'il avait de gagner)
+void update_ratings(Game *g) {
+    double expected = 1.0 / (1.0 + pow(10.0, (g->p2->rating - g->p1->rating) / 400.0));
+    double score = (g->winner == 1) ? 1.0 : 0.0;
+    int delta = (int)lround(ELO_K * (score - expected));
+
+    g->p1->rating += delta;
+    g->p2->rating -= delta;
+}
+
+// Joueur humain encore joignable (pas le bot, pas une connexion en train de se fermer)
+int player_connected(Player *p) {
+    Connection *c = conn_from_fd(p->socket);
+    return c != NULL && c->player == p && !c->closing;
+}
+
+// La partie est finie : les joueurs la quittent et le slot redevient libre tout de suite
+// Avec -r, ceux qui sont encore là repartent directement dans la file
+void release_game(Game *g) {
+    if (g->winner != 0) update_ratings(g);
+
+    Player *players[2] = {g->p1, g->p2};
+    g->p1->game = NULL;
+    g->p1->state = STATE_LOBBY;
+    g->p2->game = NULL;
+    g->p2->state = STATE_LOBBY;
 
-    // CAS 1 : Personne n'attend -> Ce joueur se met en attente
-    if (waiting_player == NULL) {
-        waiting_player = p;
-        p->state = STATE_LOBBY;
+    timer_cancel(&game_slot(g)->turn_clock);
+    game_slot(g)->bot_seq++; // Un coup du bot encore en route sera ignoré
+    pool_free(&game_pool, (uint32_t)g->id);
 
-        printf("-> Mis en file d'attente.\n");
-        send_msg(p->socket, RES_LOGIN_OK, 0, 0, 0, "En attente d'un adversaire...");
+    if (!auto_requeue) return;
+    for (int i = 0; i < 2; i++) {
+        if (player_connected(players[i])) attempt_matchmaking(players[i]);
     }
-    // CAS 2 : Quelqu'un attend -> On crée la partie !
-    else {
-        // Éviter de jouer contre soi-même (bug possible si double clic client)
-        if (waiting_player == p) return;
+}
 
-        Player *opponent = waiting_player;
+// p abandonne (déconnexion) : l'adversaire gagne par forfait
+void forfeit_game(Game *g, Player *p) {
+    Player *opp = (p == g->p1) ? g->p2 : g->p1;
 
-        // Trouver un slot
-        Game *new_game = create_game_slot();
-        if (new_game == NULL) {
-            printf("ERREUR : Serveur plein, impossible de créer une partie.\n");
-            send_msg(p->socket, RES_LOGIN_FAIL, 0, 0, 0, "Serveur plein.");
-            return;
-        }
+    g->winner = (p == g->p1) ? 2 : 1;
+    log_info("-> Partie %d : forfait de %s, gagnant : P%d", g->id, p->username, g->winner);
+    journal_end((uint32_t)g->id, g->winner, JOURNAL_END_FORFEIT);
+    send_msg(opp->socket, NOTIF_GAME_OVER, g->winner, 0, 0, "VICTOIRE (forfait)");
+    release_game(g);
+}
 
-        // Init de la partie (via src/game.c)
-        game_init(new_game, opponent, p);
+// Après le tour de p : vérifier si quelqu'un a perdu
+// Renvoie 1 si la partie est finie : g est alors libéré (son slot peut déjà resservir)
+int check_game_over(Game *g, Player *p) {
+    int player_num = (p == g->p1) ? 1 : 2;
+    Player *opp = (p == g->p1) ? g->p2 : g->p1;
+
+    int winner = 0;
+    int decided = 0;
+    int plies;
+    if (game_check_loss(g, opp)) winner = player_num; // L'adversaire est bloqué -> Je gagne
+    else if (game_check_loss(g, p)) winner = (player_num == 1 ? 2 : 1); // Je me suis bloqué -> Il gagne
+    else if ((winner = solver_solve(g, SOLVER_SERVER_CELLS, SOLVER_SERVER_NODES, &plies)) != 0) {
+        // Plateau coupé en deux : l'issue est certaine, inutile de jouer la fin
+        decided = 1;
+        log_info("-> Partie %d décidée (%d tours avant la fin), gagnant : P%d", g->id, plies, winner);
+    }
 
-        // Mise à jour des états
-        opponent->state = STATE_INGAME;
-        p->state = STATE_INGAME;
+    if (winner != 0) {
+        g->winner = winner;
+        journal_end((uint32_t)g->id, winner, decided ? JOURNAL_END_DECIDED : JOURNAL_END_BLOCKED);
+        send_msg(p->socket, NOTIF_GAME_OVER, winner, 0, 0,
+                 (winner == player_num ? (decided ? "VICTOIRE (partie décidée)" : "VICTOIRE")
+                                       : (decided ? "DÉFAITE (partie décidée)" : "DÉFAITE")));
+        send_msg(opp->socket, NOTIF_GAME_OVER, winner, 0, 0,
+                 (winner != player_num ? (decided ? "VICTOIRE (partie décidée)" : "VICTOIRE")
+                                       : (decided ? "DÉFAITE (partie décidée)" : "DÉFAITE")));
+        release_game(g);
+        return 1;
+    }
+    start_turn_clock(g);
+    return 0;
+}
 
-        // La file d'attente est vidée
-        waiting_player = NULL;
+// Nettoyage structures joueur et connexion, le slot redevient libre
+// (si elle est encore dans la liste d'envoi, c'est flush_pending() qui le rendra au pool :
+// il ne doit pas resservir tant qu'il y est chaîné)
+void release_slot(Connection *c) {
+    timer_cancel(&c->idle);
+    unindex_fd(c); // Déjà fait avant close() si le socket est fermé
+    memset(c->player, 0, sizeof(Player));
+    c->fd = 0;
+    c->rx_len = 0;
+    c->tx_head = 0;
+    c->tx_len = 0;
+    c->tx_polling = 0;
+    c->closing = 0;
+    c->handoff_to = 0;
+    memset(&c->codec, 0, sizeof(c->codec));
+    if (!c->tx_dirty) pool_free(&client_pool, c->slot);
+}
 
-        printf("-> PARTIE LANCÉE : %s (P1) vs %s (P2)\n", opponent->username, p->username);
+void handle_disconnect(Connection *c) {
+    int socket = c->fd;
+    Player *p = c->player;
 
-        // Notifier P1 (Opponent)
-        // val1 = ID Joueur (1), val2 = Largeur, val3 = Hauteur
-        send_msg(opponent->socket, NOTIF_GAME_START, 1, BOARD_WIDTH, BOARD_HEIGHT, p->username);
+    log_info("Déconnexion de %s (Socket %d)", (p->username[0] ? p->username : "Inconnu"), socket);
+    c->closing = 1; // Plus rien ne part vers lui (ni remise en file)
 
-        // Notifier P2 (Current)
-        // val1 = ID Joueur (2)
-        send_msg(p->socket, NOTIF_GAME_START, 2, BOARD_WIDTH, BOARD_HEIGHT, opponent->username);
+    // S'il attendait, il quitte la file (retrait en O(1))
+    if (p->queued) {
+        mm_remove(p);
+        log_debug("-> Il était en file d'attente (%d joueurs restants).", mm_size());
     }
+
+    // S'il était en jeu, il perd par forfait : la partie et son slot sont libérés avant lui
+    if (p->game) forfeit_game(p->game, p);
+
+    // Retrait du backend puis fermeture
+    net_remove(c);
+    unindex_fd(c);
+    close(socket);
+    metrics->closed++;
+    release_slot(c);
 }
 
-void handle_disconnect(int index_in_poll) {
-    int socket = fds[index_in_poll].fd;
-    Player *p = NULL;
+// --- CALLBACKS DU BACKEND RÉSEAU ---
 
-    // Retrouver le joueur
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (clients[i].socket == socket) {
-            p = &clients[i];
-            break;
+// CAS A : Nouvelle(s) connexion(s) sur le socket serveur
+void on_accept(int server_fd) {
+    while (1) {
+        int new_sock = accept(server_fd, NULL, NULL);
+
+        if (new_sock < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) log_error("Erreur accept : %s", strerror(errno));
+            return;
         }
+        on_accepted(new_sock);
+    }
+}
+
+// Socket client déjà accepté (par on_accept ou directement par le backend io_uring)
+void on_accepted(int new_sock) {
+    // L'adresse ne sert qu'au journal : pas d'appel système si elle n'y va pas
+    if (log_enabled(LOG_DEBUG)) {
+        struct sockaddr_in cli_addr;
+        socklen_t len = sizeof(cli_addr);
+        if (getpeername(new_sock, (struct sockaddr *)&cli_addr, &len) == 0) {
+            log_debug("Nouvelle connexion IP: %s", inet_ntoa(cli_addr.sin_addr));
+        }
+    }
+
+    // Prendre une place libre dans le pool des clients
+    uint32_t j = POOL_NONE;
+    if (new_sock >= conn_by_fd_size || net_set_nonblocking(new_sock) < 0 ||
+        (j = pool_alloc(&client_pool)) == POOL_NONE) {
+        log_warn("Refus : Serveur plein.");
+        close(new_sock);
+        return;
+    }
+    ClientSlot *slot = pool_at(&client_pool, j);
+
+    slot->player.socket = new_sock;
+    slot->player.state = STATE_LOBBY;
+    // Nom vide pour l'instant
+
+    Connection *c = &slot->conn;
+    c->fd = new_sock;
+    c->slot = j;
+    c->player = &slot->player;
+    index_fd(c);
+
+    if (net_add(c) < 0) {
+        log_error("Erreur ajout backend : %s", strerror(errno));
+        unindex_fd(c);
+        close(new_sock);
+        release_slot(c);
+        return;
     }
+    metrics->accepted++;
+    arm_idle_timer(c);
+}
 
-    if (p) {
-        printf("Déconnexion de %s (Socket %d)\n", (p->username[0] ? p->username : "Inconnu"), socket);
+// Traitement d'un message complet venant d'un client
+void handle_message(Connection *c, GameMessage *msg) {
+    Player *p = c->player;
+
+    // Logique selon le type de message
+    switch (msg->type) {
+        case MSG_HELLO_V2:
+            // Le client parle v2 : on acquitte, la suite est en trames compactes
+            if (c->codec.version != 2) break;
+            log_debug("Socket %d : protocole v2.", c->fd);
+            send_msg(c->fd, MSG_HELLO_V2, 0, 0, 0, NULL);
+            break;
+
+        case REQ_LOGIN:
+            strncpy(p->username, msg->text, 31);
+            p->username[31] = '\0';
+            // Cote annoncée à la première connexion (val1), ensuite gérée par le serveur
+            // (bornée : une cote hors tranches fausserait le matchmaking et le calcul Elo)
+            if (p->rating == 0) {
+                if (msg->val1 <= 0) p->rating = MM_DEFAULT_RATING;
+                else p->rating = (msg->val1 > MM_MAX_RATING) ? MM_MAX_RATING : msg->val1;
+            }
+            log_info("Client identifié : %s", p->username);
+            attempt_matchmaking(p);
+            break;
 
-        // Si c'était lui qui attendait, on libère la place
-        if (waiting_player == p) {
-            waiting_player = NULL;
-            printf("-> Il était en file d'attente. File vidée.\n");
+        case REQ_MOVE: { // Ajoute des accolades pour les variables locales
+            Game *g = find_game_of_player(p);
+            if (!g) break;
+
+            // 1. Vérif Tour
+            int player_num = (p == g->p1) ? 1 : 2;
+            if (g->current_turn != player_num) {
+                send_msg(p->socket, RES_MOVE_ERR, 0, 0, 0, "Pas ton tour !");
+                break;
+            }
+
+            // 2. Vérif Phase (C'EST ÇA QUI EMPÊCHE LE MOUVEMENT INFINI)
+            if (g->phase != PHASE_MOVE) {
+                send_msg(p->socket, RES_MOVE_ERR, 0, 0, 0, "Tu dois détruire une case !");
+                break;
+            }
+
+            // 3. Logique Mouvement
+            if (game_check_move(g, p, msg->val1, msg->val2)) {
+                game_apply_move(g, p, msg->val1, msg->val2);
+                journal_move((uint32_t)g->id, CELL_INDEX(msg->val1, msg->val2));
+
+                // Confirmer au joueur + Dire de passer en mode destruction
+                send_msg(p->socket, RES_MOVE_OK, msg->val1, msg->val2, 0, "Bravo. Détruis une case !");
+
+                // Avertir l'adversaire
+                Player *opp = (p == g->p1) ? g->p2 : g->p1;
+                send_msg(opp->socket, NOTIF_OPP_MOVE, msg->val1, msg->val2, 0, "L'adversaire a bougé");
+            } else {
+                send_msg(p->socket, RES_MOVE_ERR, 0, 0, 0, "Mouvement invalide");
+            }
+            break;
         }
 
-        // TODO: S'il était en jeu, gérer le forfait / fin de partie pour l'adversaire
-        // (On fera ça dans une prochaine étape)
+        case REQ_DESTROY: {
+            Game *g = find_game_of_player(p);
+            if (!g) break;
+
+            // 1. Vérifs Tour et Phase
+            int player_num = (p == g->p1) ? 1 : 2;
+            if (g->current_turn != player_num) break;
+
+            if (g->phase != PHASE_DESTROY) {
+                // On ignore silencieusement ou on envoie une erreur
+                break;
+            }
+
+            // 2. Logique Destruction
+            if (game_check_destroy(g, p, msg->val1, msg->val2)) {
+                game_apply_destroy(g, msg->val1, msg->val2);
+                journal_destroy((uint32_t)g->id, CELL_INDEX(msg->val1, msg->val2));
 
-        // Nettoyage structure joueur
-        memset(p, 0, sizeof(Player));
+                // Avertir tout le monde (la case X,Y est morte)
+                // On peut utiliser un nouveau type de message NOTIF_TILE_DESTROYED
+                // Pour simplifier, j'utilise NOTIF_OPP_MOVE avec un code spécial ou un autre type
+                // Créons un type générique ou réutilisons NOTIF pour l'instant.
+                // Mieux : Ajoutons un NOTIF_UPDATE_BOARD dans le protocole, mais restons simples :
+
+                // On envoie au joueur ET à l'adversaire que la case est détruite
+                // On va tricher un peu et utiliser val3 = -1 pour dire "C'est une destruction"
+                // Ou mieux : Définir un message NOTIF_DESTROY dans le protocole.
+
+                // Disons que msg type 9 (NOTIF_OPP_MOVE) avec val3 = 1 veut dire "Destruction"
+                // C'est sale. Ajoutons proprement le cas dans le protocole.h plus tard.
+                // Pour l'instant, supposons un code 12 = NOTIF_DESTROY
+
+                send_msg(p->socket, 12, msg->val1, msg->val2, 0, "Case détruite");
+                Player *opp = (p == g->p1) ? g->p2 : g->p1;
+                send_msg(opp->socket, 12, msg->val1, msg->val2, 0, "L'adversaire a détruit une case");
+
+                if (!check_game_over(g, p)) request_bot_turn(g);
+            }
+            break;
+        }
+
+        case REQ_TURN: { // Bouger + détruire en un seul message
+            Game *g = find_game_of_player(p);
+            if (!g) break;
+
+            // 1. Vérifs Tour et Phase (un tour complet commence forcément par un mouvement)
+            int player_num = (p == g->p1) ? 1 : 2;
+            if (g->current_turn != player_num) {
+                send_msg(p->socket, RES_MOVE_ERR, 0, 0, 0, "Pas ton tour !");
+                break;
+            }
+            if (g->phase != PHASE_MOVE) {
+                send_msg(p->socket, RES_MOVE_ERR, 0, 0, 0, "Tu dois détruire une case !");
+                break;
+            }
+
+            // 2. Case détruite : index 0..47
+            int dx = -1, dy = -1;
+            if (msg->val3 >= 0 && msg->val3 < BOARD_CELLS) {
+                dx = CELL_X(msg->val3);
+                dy = CELL_Y(msg->val3);
+            }
+
+            // 3. Tout ou rien : rien n'est joué si l'une des deux parties est invalide
+            if (!game_check_turn(g, p, msg->val1, msg->val2, dx, dy)) {
+                send_msg(p->socket, RES_MOVE_ERR, 0, 0, 0, "Tour invalide");
+                break;
+            }
+            game_apply_turn(g, p, msg->val1, msg->val2, dx, dy);
+            journal_turn((uint32_t)g->id, CELL_INDEX(msg->val1, msg->val2), msg->val3);
+
+            // Une seule notification par joueur
+            Player *opp = (p == g->p1) ? g->p2 : g->p1;
+            send_msg(p->socket, NOTIF_TURN, msg->val1, msg->val2, msg->val3, "Tour joué");
+            send_msg(opp->socket, NOTIF_TURN, msg->val1, msg->val2, msg->val3, "L'adversaire a joué");
+
+            if (!check_game_over(g, p)) request_bot_turn(g);
+            break;
+        }
+
+        case REQ_LOGOUT:
+            handle_disconnect(c);
+            break;
     }
+}
 
-    close(socket);
+// Passe la connexion à un autre shard : elle quitte ce thread sans être fermée
+void handoff_connection(Connection *c) {
+    Handoff *h = malloc(sizeof(Handoff));
+    int target = c->handoff_to - 1;
+    if (h == NULL) {
+        c->handoff_to = 0;
+        c->closing = 1;
+        mark_pending(c);
+        return;
+    }
+
+    net_remove(c);
+    timer_cancel(&c->idle); // La copie part propre, l'autre shard réarme
+    h->kind = HANDOFF_MATCH;
+    h->client.conn = *c;
+    h->client.player = *c->player;
+    h->client.conn.tx_dirty = 0;
+    h->client.conn.handoff_to = 0;
 
-    // Retrait du tableau poll (on remplace par le dernier pour boucher le trou)
-    fds[index_in_poll] = fds[nfds - 1];
-    nfds--;
+    release_slot(c);
+    shard_post(target, h);
+}
+
+// Découpe et traite toutes les trames complètes, le reste attend la prochaine lecture
+void process_rx(Connection *c) {
+    size_t off = 0;
+    GameMessage msg;
+    uint64_t started = metrics_now_ns();
+    while (1) {
+        size_t used = frame_decode(&c->codec, c->rx + off, c->rx_len - off, &msg);
+        if (used == 0) break;
+        off += used;
+
+        // Décodage + traitement, par type de message (une lecture d'horloge par message)
+        int type = metrics_type(msg.type);
+        handle_message(c, &msg);
+        uint64_t done = metrics_now_ns();
+        metrics->msg_in[type]++;
+        hist_add(&metrics->handle_ns[type], done - started);
+        started = done;
+        if (c->fd == 0 || c->closing) return; // Déconnecté pendant le traitement
+        if (c->handoff_to) break;             // La suite sera traitée par l'autre shard
+    }
+
+    c->rx_len -= off;
+    if (off > 0 && c->rx_len > 0) memmove(c->rx, c->rx + off, c->rx_len);
+
+    if (c->handoff_to) {
+        handoff_connection(c);
+        return;
+    }
+    arm_idle_timer(c);
+}
+
+// CAS B : Données reçues d'un Client
+void on_readable(Connection *c) {
+    // Connexion fermée plus tôt dans le même lot d'événements
+    if (c == NULL || c->fd == 0 || c->closing) return;
+
+    // On vide le socket d'un coup dans le tampon de la connexion
+    ssize_t n = recv(c->fd, c->rx + c->rx_len, CONN_RX_SIZE - c->rx_len, 0);
+
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return;
+
+    if (n <= 0) {
+        // Erreur ou Déconnexion (0)
+        handle_disconnect(c);
+        return;
+    }
+    c->rx_len += n;
+    metrics->bytes_in += (uint64_t)n;
+    process_rx(c);
+}
+
+// CAS B bis : Données déjà lues par le backend (io_uring)
+void on_data(Connection *c, const uint8_t *data, size_t len) {
+    if (c == NULL || c->fd == 0 || c->closing) return;
+
+    if (len > CONN_RX_SIZE - c->rx_len) {
+        log_warn("Trame trop longue (Socket %d), déconnexion.", c->fd);
+        on_closed(c);
+        return;
+    }
+    memcpy(c->rx + c->rx_len, data, len);
+    c->rx_len += len;
+    metrics->bytes_in += len;
+    process_rx(c);
+}
+
+// Le backend a constaté la fin de la connexion (fermée par le client ou erreur)
+void on_closed(Connection *c) {
+    if (c == NULL || c->fd == 0 || c->closing) return;
+    c->closing = 1;
+    mark_pending(c);
+}
+
+// CAS C : Le socket peut de nouveau recevoir des données en attente
+void on_writable(Connection *c) {
+    if (c == NULL || c->fd == 0 || c->closing) return;
+
+    if (net_flush(c) < 0) {
+        c->closing = 1;
+        mark_pending(c);
+    }
+}
+
+// Coup calculé par un thread du bot
+void apply_bot_turn(Handoff *h) {
+    GameSlot *slot = pool_at(&game_pool, (uint32_t)h->bot.game_id);
+    if (slot == NULL) return;
+    Game *g = &slot->game;
+
+    // Réponse périmée : partie finie, humain parti ou demande plus récente
+    if (h->bot.seq != slot->bot_seq || g->winner != 0 || g->p1->game != g) return;
+
+    Player *bot = (g->current_turn == 1) ? g->p1 : g->p2;
+    Player *opp = (bot == g->p1) ? g->p2 : g->p1;
+    if (bot->socket != BOT_SOCKET || g->phase != PHASE_MOVE) return;
+
+    int x = CELL_X(h->bot.turn.to), y = CELL_Y(h->bot.turn.to);
+    int dx = CELL_X(h->bot.turn.destroy), dy = CELL_Y(h->bot.turn.destroy);
+    int found = h->bot.found;
+    if (found && !game_check_turn(g, bot, x, y, dx, dy)) {
+        // Ne devrait pas arriver (le bot cherche sur une copie de cette position) ;
+        // le redemander donnerait le même tour : la partie s'arrête comme s'il était bloqué
+        log_error("Partie %d : tour du bot refusé (%d,%d) / (%d,%d).", g->id, x, y, dx, dy);
+        found = 0;
+    }
+
+    if (!found) {
+        // Aucun tour possible : le bot est bloqué, c'est perdu pour lui
+        g->winner = (bot == g->p1) ? 2 : 1;
+        journal_end((uint32_t)g->id, g->winner, JOURNAL_END_BLOCKED);
+        send_msg(opp->socket, NOTIF_GAME_OVER, g->winner, 0, 0, "VICTOIRE");
+        release_game(g);
+        return;
+    }
+
+    game_apply_turn(g, bot, x, y, dx, dy);
+    journal_turn((uint32_t)g->id, h->bot.turn.to, h->bot.turn.destroy);
+
+    // Mêmes notifications que pour un adversaire humain qui joue en deux messages
+    send_msg(opp->socket, NOTIF_OPP_MOVE, x, y, 0, "L'adversaire a bougé");
+    send_msg(opp->socket, NOTIF_DESTROY, dx, dy, 0, "L'adversaire a détruit une case");
+    check_game_over(g, bot);
+}
+
+// Connexion arrivée d'un autre shard
+void adopt_connection(Handoff *h) {
+    int fd = h->client.conn.fd;
+
+    uint32_t j = pool_alloc(&client_pool);
+    if (j == POOL_NONE) {
+        log_warn("Refus du transfert : Serveur plein.");
+        close(fd);
+        return;
+    }
+    ClientSlot *slot = pool_at(&client_pool, j);
+
+    slot->player = h->client.player;
+    uint32_t gen = slot->conn.gen; // La génération suit le slot, pas la connexion
+    slot->conn = h->client.conn;
+    Connection *c = &slot->conn;
+    c->gen = gen;
+    c->slot = j;
+    c->player = &slot->player;
+    c->tx_polling = 0;
+    index_fd(c);
+
+    if (net_add(c) < 0) {
+        log_error("Erreur ajout backend : %s", strerror(errno));
+        unindex_fd(c);
+        close(fd);
+        release_slot(c);
+        return;
+    }
+    if (c->tx_len > 0) mark_pending(c);
+
+    // Joueur venu chercher un adversaire ici : il garde son ancienneté dans la file
+    mm_enqueue(c->player, now_ms());
+    process_rx(c);
+}
+
+// Le backend sort de l'attente : un tour de boucle commence
+void on_events(void) {
+    loop_started_ns = metrics_now_ns();
+}
+
+// CAS D : Messages d'autres threads (connexions transférées, coups du bot)
+void on_wakeup(void) {
+    Handoff *h = shard_take_all();
+    while (h) {
+        Handoff *next = h->next;
+        if (h->kind == HANDOFF_MATCH) adopt_connection(h);
+        else if (h->kind == HANDOFF_BOT_TURN) apply_bot_turn(h);
+        free(h);
+        h = next;
+    }
+}
+
+// Délai (ms) avant le prochain travail planifié (minuteries, matchmaking), -1 si rien n'est prévu
+int next_timeout() {
+    uint64_t now = now_ms();
+    int timeout = timer_next_ms(now);
+    if (mm_size() > 0) {
+        int mm = (next_mm_tick > now) ? (int)(next_mm_tick - now) : 0;
+        if (timeout < 0 || mm < timeout) timeout = mm;
+    }
+    return timeout;
+}
+
+// Instant "il y a ms millisecondes" (0 si l'horloge est plus jeune que ça)
+static uint64_t ms_ago(uint64_t now, uint64_t ms) {
+    return (now > ms) ? now - ms : 0;
+}
+
+// Travail planifié, après chaque réveil de la boucle : minuteries échues, puis un passage
+// de matchmaking par tick
+void server_tick() {
+    uint64_t now = now_ms();
+    timer_advance(now);
+
+    if (mm_size() == 0 || now < next_mm_tick) return;
+    next_mm_tick = now + MM_TICK_MS;
+
+    // 1. Toutes les paires compatibles du moment
+    Player *a, *b;
+    while (mm_next_pair(now, &a, &b)) {
+        if (!start_game(a, b)) {
+            log_error("Serveur plein, impossible de créer une partie.");
+            mm_enqueue(a, now);
+            mm_enqueue(b, now);
+            break;
+        }
+    }
+
+    // 2. Seuls sur ce shard depuis un moment : direction la file du shard 0
+    Player *p;
+    if (shard_id != 0) {
+        while ((p = mm_pop_older_than(ms_ago(now, MM_EXPORT_MS))) != NULL) {
+            log_info("[MATCHMAKING] %s part vers le shard 0.", p->username);
+            Connection *c = conn_from_fd(p->socket);
+            c->handoff_to = 1;
+            handoff_connection(c);
+        }
+        return;
+    }
+
+    // 3. Personne pour lui depuis trop longtemps : partie contre le bot
+    while ((p = mm_pop_older_than(ms_ago(now, BOT_MATCH_DELAY_MS))) != NULL) {
+        log_info("[MATCHMAKING] Personne pour %s, partie contre le bot.", p->username);
+        if (!start_bot_game(p)) {
+            mm_enqueue(p, now);
+            break;
+        }
+    }
 }
 
 // --- MAIN ---
 
-int main() {
-    // 1. Setup Réseau
+// Boucle d'un shard (un par thread)
+void run_shard(int id) {
+    // 1. Setup Réseau (un socket d'écoute par shard, SO_REUSEPORT)
     int server_fd = setup_server_socket();
 
     // 2. Init structures
-    memset(clients, 0, sizeof(clients));
-    memset(games, 0, sizeof(games));
-
-    // 3. Init Poll (Le slot 0 est pour le serveur)
-    memset(fds, 0, sizeof(fds));
-    fds[0].fd = server_fd;
-    fds[0].events = POLLIN;
-    nfds = 1;
+    init_pools();
+    timer_init(now_ms());
+    metrics_init_shard();
+
+    // 3. Init du backend (poll ou epoll selon la compilation) + réveil inter-shards
+    int wakeup_fd = shard_mailbox_open();
+    if (net_init(server_fd) < 0 || wakeup_fd < 0 || net_add_wakeup(wakeup_fd) < 0) {
+        perror("Echec init backend");
+        exit(EXIT_FAILURE);
+    }
 
-    printf("Serveur prêt. En attente de connexions...\n");
+    if (id == 0) log_info("Serveur prêt. En attente de connexions...");
 
     // 4. Boucle principale
     while (1) {
-        // Attente d'événements (-1 = infini)
-        int poll_count = poll(fds, nfds, -1);
-
-        if (poll_count < 0) {
-            perror("Erreur poll");
+        // Attente d'événements (jusqu'au prochain travail planifié), le backend appelle on_accept / on_readable
+        if (net_wait(next_timeout()) < 0) {
+            log_error("Erreur poll : %s", strerror(errno));
             break;
         }
+        server_tick();
 
-        // Parcours des sockets actifs
-        for (int i = 0; i < nfds; i++) {
-
-            // Si aucun événement sur ce socket, on passe
-            if (fds[i].revents == 0) continue;
-
-            // --- CAS A : Nouvelle Connexion (Sur le socket serveur) ---
-            if (fds[i].fd == server_fd) {
-                struct sockaddr_in cli_addr;
-                socklen_t len = sizeof(cli_addr);
-                int new_sock = accept(server_fd, (struct sockaddr *)&cli_addr, &len);
-
-                if (new_sock >= 0) {
-                    printf("Nouvelle connexion IP: %s\n", inet_ntoa(cli_addr.sin_addr));
-
-                    // Ajout à poll
-                    if (nfds < MAX_CLIENTS) {
-                        fds[nfds].fd = new_sock;
-                        fds[nfds].events = POLLIN;
-                        nfds++;
-
-                        // Trouver une place dans clients[]
-                        for (int j = 0; j < MAX_CLIENTS; j++) {
-                            if (clients[j].socket == 0) {
-                                clients[j].socket = new_sock;
-                                clients[j].state = STATE_LOBBY;
-                                // Nom vide pour l'instant
-                                break;
-                            }
-                        }
-                    } else {
-                        printf("Refus : Serveur plein.\n");
-                        close(new_sock);
-                    }
-                }
-            }
-            // --- CAS B : Message reçu d'un Client ---
-            else if (fds[i].revents & POLLIN) {
-                GameMessage msg;
-                // On essaie de lire la taille exacte d'une structure GameMessage
-                int n = recv(fds[i].fd, &msg, sizeof(msg), 0);
-
-                if (n <= 0) {
-                    // Erreur ou Déconnexion (0)
-                    handle_disconnect(i);
-                    i--; // Important car on a modifié le tableau fds !
-                } else {
-                    // --- TRAITEMENT DU MESSAGE ---
-
-                    // 1. Retrouver le pointeur du joueur
-                    Player *p = NULL;
-                    for (int j = 0; j < MAX_CLIENTS; j++) {
-                        if (clients[j].socket == fds[i].fd) {
-                            p = &clients[j];
-                            break;
-                        }
-                    }
-
-                    if (p) {
-                        // Logique selon le type de message
-                        switch (msg.type) {
-                            case REQ_LOGIN:
-                                strncpy(p->username, msg.text, 31);
-                                p->username[31] = '\0';
-                                printf("Client identifié : %s\n", p->username);
-                                attempt_matchmaking(p);
-                                break;
-
-                            case REQ_MOVE: { // Ajoute des accolades pour les variables locales
-                                Game *g = find_game_of_player(p);
-                                if (!g) break;
-
-                                // 1. Vérif Tour
-                                int player_num = (p == g->p1) ? 1 : 2;
-                                if (g->current_turn != player_num) {
-                                    send_msg(p->socket, RES_MOVE_ERR, 0, 0, 0, "Pas ton tour !");
-                                    break;
-                                }
-
-                                // 2. Vérif Phase (C'EST ÇA QUI EMPÊCHE LE MOUVEMENT INFINI)
-                                if (g->phase != PHASE_MOVE) {
-                                    send_msg(p->socket, RES_MOVE_ERR, 0, 0, 0, "Tu dois détruire une case !");
-                                    break;
-                                }
-
-                                // 3. Logique Mouvement
-                                if (game_check_move(g, p, msg.val1, msg.val2)) {
-                                    game_apply_move(g, p, msg.val1, msg.val2);
-
-                                    // Confirmer au joueur + Dire de passer en mode destruction
-                                    send_msg(p->socket, RES_MOVE_OK, msg.val1, msg.val2, 0, "Bravo. Détruis une case !");
-
-                                    // Avertir l'adversaire
-                                    Player *opp = (p == g->p1) ? g->p2 : g->p1;
-                                    send_msg(opp->socket, NOTIF_OPP_MOVE, msg.val1, msg.val2, 0, "L'adversaire a bougé");
-                                } else {
-                                    send_msg(p->socket, RES_MOVE_ERR, 0, 0, 0, "Mouvement invalide");
-                                }
-                                break;
-                            }
-
-                            case REQ_DESTROY: {
-                                Game *g = find_game_of_player(p);
-                                if (!g) break;
-
-                                // 1. Vérifs Tour et Phase
-                                int player_num = (p == g->p1) ? 1 : 2;
-                                if (g->current_turn != player_num) break;
-
-                                if (g->phase != PHASE_DESTROY) {
-                                    // On ignore silencieusement ou on envoie une erreur
-                                    break;
-                                }
-
-                                // 2. Logique Destruction
-                                if (game_check_destroy(g, p, msg.val1, msg.val2)) {
-                                    game_apply_destroy(g, msg.val1, msg.val2);
-
-                                    // Avertir tout le monde (la case X,Y est morte)
-                                    // On peut utiliser un nouveau type de message NOTIF_TILE_DESTROYED
-                                    // Pour simplifier, j'utilise NOTIF_OPP_MOVE avec un code spécial ou un autre type
-                                    // Créons un type générique ou réutilisons NOTIF pour l'instant.
-                                    // Mieux : Ajoutons un NOTIF_UPDATE_BOARD dans le protocole, mais restons simples :
-
-                                    // On envoie au joueur ET à l'adversaire que la case est détruite
-                                    // On va tricher un peu et utiliser val3 = -1 pour dire "C'est une destruction"
-                                    // Ou mieux : Définir un message NOTIF_DESTROY dans le protocole.
-
-                                    // Disons que msg type 9 (NOTIF_OPP_MOVE) avec val3 = 1 veut dire "Destruction"
-                                    // C'est sale. Ajoutons proprement le cas dans le protocole.h plus tard.
-                                    // Pour l'instant, supposons un code 12 = NOTIF_DESTROY
-
-                                    send_msg(p->socket, 12, msg.val1, msg.val2, 0, "Case détruite");
-                                    Player *opp = (p == g->p1) ? g->p2 : g->p1;
-                                    send_msg(opp->socket, 12, msg.val1, msg.val2, 0, "L'adversaire a détruit une case");
-
-                                    // Vérifier si quelqu'un a perdu
-                                    int winner = 0;
-                                    if (game_check_loss(g, opp)) winner = player_num; // L'adversaire est bloqué -> Je gagne
-                                    else if (game_check_loss(g, p)) winner = (player_num == 1 ? 2 : 1); // Je me suis bloqué -> Il gagne
-
-                                    if (winner != 0) {
-                                        send_msg(p->socket, NOTIF_GAME_OVER, winner, 0, 0, (winner == player_num ? "VICTOIRE" : "DÉFAITE"));
-                                        send_msg(opp->socket, NOTIF_GAME_OVER, winner, 0, 0, (winner != player_num ? "VICTOIRE" : "DÉFAITE"));
-                                        // Reset partie...
-                                    }
-
-                                }
-                                break;
-                            }
-
-                            case REQ_LOGOUT:
-                                handle_disconnect(i);
-                                i--;
-                                break;
-                        }
-                    }
+        // Un seul writev par socket pour tous les messages produits pendant ce tour
+        flush_pending();
+        journal_commit();
+
+        // Durée du tour (hors attente) et état du shard pour le port de stats
+        hist_add(&metrics->loop_ns, metrics_now_ns() - loop_started_ns);
+        metrics->connections = client_pool.live;
+        metrics->games = game_pool.live;
+        metrics->queued = (uint64_t)mm_size();
+    }
+
+    // Nettoyage final (si on sort du while, ce qui n'arrive pas ici)
+    close(server_fd);
+}
+
+int main(int argc, char **argv) {
+    // Options : -t <threads> (un shard par thread, 1 par défaut), -b <livre d'ouvertures>,
+    // -c <clients par shard> (MAX_CLIENTS par défaut), -r (remise en file après chaque partie),
+    // -s <port des stats> (STATS_PORT par défaut, 0 = aucun),
+    // -l <niveau du journal> (erreur, alerte, info, debug ; info par défaut),
+    // -j <dossier du journal des parties> (aucun par défaut), -f <ms entre deux fdatasync du journal>
+    const char *book_path = BOOK_PATH;
+    const char *journal_path = NULL;
+    int journal_fsync_ms = JOURNAL_FSYNC_MS;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:b:c:rs:l:j:f:")) != -1) {
+        switch (opt) {
+            case 't':
+                shard_count = atoi(optarg);
+                break;
+            case 'c':
+                max_clients = atoi(optarg);
+                if (max_clients < 1) max_clients = 1;
+                break;
+            case 'b':
+                book_path = optarg;
+                break;
+            case 'r':
+                auto_requeue = 1;
+                break;
+            case 's':
+                stats_port = atoi(optarg);
+                break;
+            case 'l': {
+                int level = log_parse_level(optarg);
+                if (level < 0) {
+                    fprintf(stderr, "Niveau de journal inconnu : %s\n", optarg);
+                    return EXIT_FAILURE;
                 }
+                atomic_store(&log_level, level);
+                break;
             }
+            case 'j':
+                journal_path = optarg;
+                break;
+            case 'f':
+                journal_fsync_ms = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "Usage : %s [-t threads] [-c clients] [-r] [-s port stats] [-l niveau] [-j journal] [-f ms] [-b livre]\n", argv[0]);
+                return EXIT_FAILURE;
         }
     }
 
-    // Nettoyage final (si on sort du while, ce qui n'arrive pas ici)
-    close(server_fd);
+    // Un client parti pendant un writev() ne doit pas tuer le serveur (SIGPIPE) : on aura EPIPE
+    signal(SIGPIPE, SIG_IGN);
+
+    // Journal sur son propre thread ; kill -USR1 change le niveau en cours de route
+    if (log_start() < 0) {
+        perror("Echec thread du journal");
+        return EXIT_FAILURE;
+    }
+    signal(SIGUSR1, log_on_signal);
+
+    init_fd_index();
+    if (tt_init(BOT_TT_MB) < 0) {
+        perror("Echec allocation table de transposition");
+        return EXIT_FAILURE;
+    }
+    if (book_open(book_path) == 0) log_info("Livre d'ouvertures : %s (%lu positions)", book_path, (unsigned long)book_size());
+    else log_info("Pas de livre d'ouvertures (%s), le bot cherchera dès le premier coup.", book_path);
+
+    if (journal_path != NULL) {
+        if (journal_open(journal_path, journal_fsync_ms) < 0) {
+            perror("Echec ouverture du journal des parties");
+            return EXIT_FAILURE;
+        }
+        log_info("Journal des parties : %s (fdatasync toutes les %d ms)", journal_path, journal_fsync_ms);
+    }
+
+    if (metrics_start(stats_port) < 0) perror("Echec port de stats");
+    else if (stats_port) log_info("Stats : 127.0.0.1:%d", stats_port);
+
+    bot_start(BOT_THREADS, BOT_SEARCH_THREADS, BOT_TIME_MS);
+    shard_run_all(run_shard);
     return 0;
-}
\ No newline at end of file
+}
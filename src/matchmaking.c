@@ -0,0 +1,132 @@
+//
+// File de matchmaking par tranches de cote (listes intrusives + bitmap)
+//
+#include <stddef.h>
+#include "../include/matchmaking.h"
+#include "../include/shard.h"
+
+typedef struct {
+    Player *head[MM_BUCKETS]; // Le plus ancien de la tranche
+    Player *tail[MM_BUCKETS];
+    uint64_t occupied;        // Bit b = tranche b non vide
+    int count;
+} MatchQueue;
+
+_Static_assert(MM_BUCKETS <= 64, "Le bitmap des tranches tient dans un uint64_t");
+
+static SHARD_LOCAL MatchQueue queue;
+
+static int bucket_of(int rating) {
+    int b = rating / MM_BUCKET_WIDTH;
+    if (b < 0) return 0;
+    if (b >= MM_BUCKETS) return MM_BUCKETS - 1;
+    return b;
+}
+
+void mm_enqueue(Player *p, uint64_t now) {
+    if (p->queued) return;
+
+    int b = bucket_of(p->rating);
+    if (p->queued_at == 0) p->queued_at = now;
+
+    // En fin de tranche, ou en tête s'il attend depuis plus longtemps que la tête (joueur
+    // transféré ou remis en file). Sans parcours : un transféré plus jeune que la tête passe
+    // derrière ceux déjà arrivés, même s'ils sont plus jeunes que lui
+    Player *head = queue.head[b];
+    Player *prev = (head && p->queued_at < head->queued_at) ? NULL : queue.tail[b];
+
+    p->queued = 1;
+    p->queue_prev = prev;
+    p->queue_next = prev ? prev->queue_next : queue.head[b];
+    if (prev) prev->queue_next = p;
+    else queue.head[b] = p;
+    if (p->queue_next) p->queue_next->queue_prev = p;
+    else queue.tail[b] = p;
+
+    queue.occupied |= 1ULL << b;
+    queue.count++;
+}
+
+void mm_remove(Player *p) {
+    if (!p->queued) return;
+
+    int b = bucket_of(p->rating);
+    if (p->queue_prev) p->queue_prev->queue_next = p->queue_next;
+    else queue.head[b] = p->queue_next;
+    if (p->queue_next) p->queue_next->queue_prev = p->queue_prev;
+    else queue.tail[b] = p->queue_prev;
+
+    if (queue.head[b] == NULL) queue.occupied &= ~(1ULL << b);
+    p->queue_prev = NULL;
+    p->queue_next = NULL;
+    p->queued = 0;
+    queue.count--;
+}
+
+int mm_size(void) {
+    return queue.count;
+}
+
+// Tranches [lo, hi] sous forme de masque
+static uint64_t bucket_range(int lo, int hi) {
+    if (lo < 0) lo = 0;
+    if (hi > MM_BUCKETS - 1) hi = MM_BUCKETS - 1;
+    uint64_t upto_hi = (hi >= 63) ? ~0ULL : (1ULL << (hi + 1)) - 1;
+    return upto_hi & ~((1ULL << lo) - 1);
+}
+
+int mm_next_pair(uint64_t now, Player **a, Player **b) {
+    // Une tête par tranche : c'est le plus ancien de sa tranche qui cherche
+    uint64_t heads = queue.occupied;
+    while (heads) {
+        int bucket = __builtin_ctzll(heads);
+        heads &= heads - 1;
+
+        Player *p = queue.head[bucket];
+        Player *q = p->queue_next; // Même tranche : toujours compatible
+
+        if (q == NULL) {
+            uint64_t waited = (now > p->queued_at) ? now - p->queued_at : 0;
+            int window = MM_BASE_WINDOW + (int)(waited / MM_WIDEN_MS);
+            uint64_t candidates = queue.occupied & bucket_range(bucket - window, bucket + window)
+                                & ~(1ULL << bucket);
+            if (candidates == 0) continue;
+
+            // Tranche non vide la plus proche, au-dessus ou en dessous
+            uint64_t above = candidates >> bucket;
+            uint64_t below = candidates & ((1ULL << bucket) - 1);
+            int up = above ? bucket + __builtin_ctzll(above) : -1;
+            int down = below ? 63 - __builtin_clzll(below) : -1;
+            int pick = up;
+            if (down >= 0 && (up < 0 || bucket - down < up - bucket
+                              || (bucket - down == up - bucket
+                                  && queue.head[down]->queued_at < queue.head[up]->queued_at))) {
+                pick = down;
+            }
+            q = queue.head[pick];
+        }
+
+        mm_remove(p);
+        mm_remove(q);
+        // Le plus ancien des deux joue en premier
+        if (q->queued_at < p->queued_at) { Player *t = p; p = q; q = t; }
+        *a = p;
+        *b = q;
+        return 1;
+    }
+    return 0;
+}
+
+Player *mm_pop_older_than(uint64_t deadline) {
+    Player *oldest = NULL;
+    uint64_t heads = queue.occupied;
+    while (heads) {
+        Player *p = queue.head[__builtin_ctzll(heads)];
+        heads &= heads - 1;
+        if (oldest == NULL || p->queued_at < oldest->queued_at) oldest = p;
+    }
+
+    if (oldest == NULL || oldest->queued_at > deadline) return NULL;
+    mm_remove(oldest);
+    return oldest;
+}
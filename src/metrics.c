@@ -0,0 +1,203 @@
+//
+// Métriques par shard et port de stats en texte (voir include/metrics.h)
+//
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include "../include/metrics.h"
+
+SHARD_LOCAL ShardMetrics *metrics = NULL;
+
+// Métriques de chaque shard, publiées une fois au démarrage du shard
+static _Atomic(ShardMetrics *) all_metrics[MAX_SHARDS];
+
+static uint64_t started_ns = 0;
+
+// Noms des types (index = metrics_type)
+static const char *type_names[METRICS_MSG_TYPES] = {
+    "HELLO_V2", "REQ_LOGIN", "RES_LOGIN_OK", "RES_LOGIN_FAIL", "NOTIF_GAME_START",
+    "REQ_MOVE", "REQ_DESTROY", "RES_MOVE_OK", "RES_MOVE_ERR", "NOTIF_OPP_MOVE",
+    "NOTIF_GAME_OVER", "REQ_LOGOUT", "NOTIF_DESTROY", "REQ_TURN", "NOTIF_TURN", "INCONNU"
+};
+
+static const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+void metrics_init_shard(void) {
+    metrics = calloc(1, sizeof(ShardMetrics));
+    if (metrics == NULL) {
+        perror("Echec allocation métriques");
+        exit(EXIT_FAILURE);
+    }
+    atomic_store_explicit(&all_metrics[shard_id], metrics, memory_order_release);
+}
+
+// --- Rapport texte ---
+
+typedef struct {
+    char *data;
+    size_t len, cap;
+} Report;
+
+static void report_printf(Report *r, const char *fmt, ...) {
+    va_list ap;
+    while (1) {
+        va_start(ap, fmt);
+        int n = vsnprintf(r->data + r->len, r->cap - r->len, fmt, ap);
+        va_end(ap);
+        if (n < 0) return;
+        if ((size_t)n < r->cap - r->len) {
+            r->len += (size_t)n;
+            return;
+        }
+        size_t cap = r->cap * 2 + (size_t)n;
+        char *data = realloc(r->data, cap);
+        if (data == NULL) return;
+        r->data = data;
+        r->cap = cap;
+    }
+}
+
+static void report_histogram(Report *r, const char *name, const char *labels, const Histogram *h) {
+    const char *sep = labels[0] ? "," : "";
+    for (size_t i = 0; i < sizeof(quantiles) / sizeof(quantiles[0]); i++) {
+        report_printf(r, "isola_%s{%s%sq=\"%g\"} %lu\n", name, labels, sep, quantiles[i],
+                      (unsigned long)hist_quantile(h, quantiles[i]));
+    }
+    const char *open = labels[0] ? "{" : "", *close = labels[0] ? "}" : "";
+    report_printf(r, "isola_%s_max%s%s%s %lu\n", name, open, labels, close, (unsigned long)h->max);
+    report_printf(r, "isola_%s_count%s%s%s %lu\n", name, open, labels, close, (unsigned long)h->total);
+}
+
+// Somme des shards (copie locale : les shards continuent d'écrire pendant ce temps)
+static void build_report(Report *r) {
+    ShardMetrics *sum = calloc(1, sizeof(ShardMetrics));
+    if (sum == NULL) return;
+
+    report_printf(r, "isola_uptime_seconds %lu\n", (unsigned long)((metrics_now_ns() - started_ns) / 1000000000ULL));
+    report_printf(r, "isola_shards %d\n", shard_count);
+
+    for (int s = 0; s < shard_count && s < MAX_SHARDS; s++) {
+        const ShardMetrics *m = atomic_load_explicit(&all_metrics[s], memory_order_acquire);
+        if (m == NULL) continue;
+
+        report_printf(r, "isola_connections{shard=\"%d\"} %lu\n", s, (unsigned long)m->connections);
+        report_printf(r, "isola_games{shard=\"%d\"} %lu\n", s, (unsigned long)m->games);
+        report_printf(r, "isola_queue{shard=\"%d\"} %lu\n", s, (unsigned long)m->queued);
+
+        for (int t = 0; t < METRICS_MSG_TYPES; t++) {
+            sum->msg_in[t] += m->msg_in[t];
+            sum->msg_out[t] += m->msg_out[t];
+            hist_merge(&sum->handle_ns[t], &m->handle_ns[t]);
+        }
+        sum->bytes_in += m->bytes_in;
+        sum->bytes_out += m->bytes_out;
+        sum->accepted += m->accepted;
+        sum->closed += m->closed;
+        sum->connections += m->connections;
+        sum->games += m->games;
+        sum->queued += m->queued;
+        hist_merge(&sum->loop_ns, &m->loop_ns);
+    }
+
+    report_printf(r, "isola_connections %lu\n", (unsigned long)sum->connections);
+    report_printf(r, "isola_games %lu\n", (unsigned long)sum->games);
+    report_printf(r, "isola_queue %lu\n", (unsigned long)sum->queued);
+    report_printf(r, "isola_accepted_total %lu\n", (unsigned long)sum->accepted);
+    report_printf(r, "isola_closed_total %lu\n", (unsigned long)sum->closed);
+    report_printf(r, "isola_bytes_in_total %lu\n", (unsigned long)sum->bytes_in);
+    report_printf(r, "isola_bytes_out_total %lu\n", (unsigned long)sum->bytes_out);
+
+    for (int t = 0; t < METRICS_MSG_TYPES; t++) {
+        if (sum->msg_in[t]) report_printf(r, "isola_msg_in_total{type=\"%s\"} %lu\n", type_names[t], (unsigned long)sum->msg_in[t]);
+    }
+    for (int t = 0; t < METRICS_MSG_TYPES; t++) {
+        if (sum->msg_out[t]) report_printf(r, "isola_msg_out_total{type=\"%s\"} %lu\n", type_names[t], (unsigned long)sum->msg_out[t]);
+    }
+    for (int t = 0; t < METRICS_MSG_TYPES; t++) {
+        if (sum->handle_ns[t].total == 0) continue;
+        char labels[48];
+        snprintf(labels, sizeof(labels), "type=\"%s\"", type_names[t]);
+        report_histogram(r, "handle_ns", labels, &sum->handle_ns[t]);
+    }
+    report_histogram(r, "loop_ns", "", &sum->loop_ns);
+    free(sum);
+}
+
+// --- Thread du port de stats : une connexion = un rapport, puis fermeture ---
+
+static void *stats_thread(void *arg) {
+    int listen_fd = (int)(intptr_t)arg;
+    Report r = {NULL, 0, 0};
+    const struct timespec retry = {0, STATS_RETRY_MS * 1000000L};
+    const struct timeval send_timeout = {STATS_SEND_TIMEOUT_MS / 1000, (STATS_SEND_TIMEOUT_MS % 1000) * 1000};
+
+    while (1) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            // Plus de fd (ou de mémoire) : les shards en manquent aussi, on ne tourne pas à vide
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                nanosleep(&retry, NULL);
+                continue;
+            }
+            break; // Socket d'écoute inutilisable : plus de port de stats
+        }
+        // Un lecteur qui ne lit plus ne bloque pas le port pour les suivants
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+
+        r.len = 0;
+        if (r.data == NULL && (r.data = malloc(r.cap = 16384)) == NULL) r.cap = 0;
+        if (r.data != NULL) build_report(&r);
+
+        size_t off = 0;
+        while (off < r.len) {
+            ssize_t n = send(fd, r.data + off, r.len - off, MSG_NOSIGNAL);
+            if (n <= 0) break;
+            off += (size_t)n;
+        }
+        close(fd);
+    }
+    free(r.data);
+    close(listen_fd);
+    return NULL;
+}
+
+int metrics_start(int port) {
+    started_ns = metrics_now_ns();
+    if (port == 0) return 0;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    int opt = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    // Local seulement : les stats ne sortent pas de la machine
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((uint16_t)port);
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(fd, 16) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    pthread_t t;
+    if (pthread_create(&t, NULL, stats_thread, (void *)(intptr_t)fd) != 0) {
+        close(fd);
+        return -1;
+    }
+    pthread_detach(t);
+    return 0;
+}
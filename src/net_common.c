@@ -0,0 +1,59 @@
+//
+// Code commun aux backends par disponibilité (poll, epoll)
+//
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include "../include/net.h"
+#include "../include/log.h"
+
+// Envoie tout ce qui est en file avec un seul writev()
+// Renvoie -1 si la connexion est morte
+int net_writev_flush(Connection *c) {
+    while (c->tx_len > 0) {
+        struct iovec iov[2];
+        int iovcnt = 1;
+        uint32_t first = CONN_TX_SIZE - c->tx_head;
+
+        iov[0].iov_base = c->tx + c->tx_head;
+        if (first >= c->tx_len) {
+            iov[0].iov_len = c->tx_len;
+        } else {
+            iov[0].iov_len = first;
+            iov[1].iov_base = c->tx;
+            iov[1].iov_len = c->tx_len - first;
+            iovcnt = 2;
+        }
+
+        ssize_t n = writev(c->fd, iov, iovcnt);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            log_warn("Erreur writev (Socket %d) : %s", c->fd, strerror(errno));
+            return -1;
+        }
+
+        c->tx_head = (c->tx_head + (uint32_t)n) % CONN_TX_SIZE;
+        c->tx_len -= (uint32_t)n;
+    }
+
+    if (c->tx_len == 0) c->tx_head = 0;
+
+    // On ne surveille l'écriture que tant qu'il reste des données
+    int want = c->tx_len > 0;
+    if (want != c->tx_polling) {
+        net_want_write(c, want);
+        c->tx_polling = (uint8_t)want;
+    }
+    return 0;
+}
+
+// Passe un socket en mode non bloquant
+int net_set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) return -1;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
@@ -0,0 +1,89 @@
+//
+// Backend epoll : le noyau ne renvoie que les sockets actifs,
+// et chaque événement porte directement le pointeur vers sa Connection.
+//
+#include <sys/epoll.h>
+#include <errno.h>
+#include <unistd.h>
+#include "../include/net.h"
+#include "../include/shard.h"
+
+#define MAX_EVENTS 256
+
+static SHARD_LOCAL int epfd = -1;
+static SHARD_LOCAL int listen_fd = -1;
+
+// Marqueur de l'eventfd de réveil dans data.ptr
+static char wakeup_marker;
+
+const char *net_backend_name(void) {
+    return "epoll";
+}
+
+int net_init(int server_fd) {
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) return -1;
+    listen_fd = server_fd;
+
+    // Le socket serveur est repéré par data.ptr == NULL
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = NULL };
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, server_fd, &ev);
+}
+
+int net_add(Connection *c) {
+    c->gen++; // Nouvelle connexion dans ce slot (voir net_wait)
+    struct epoll_event ev = { .events = EPOLLIN | EPOLLRDHUP, .data.ptr = c };
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, c->fd, &ev);
+}
+
+int net_add_wakeup(int fd) {
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &wakeup_marker };
+    return epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+int net_flush(Connection *c) {
+    return net_writev_flush(c);
+}
+
+void net_want_write(Connection *c, int on) {
+    struct epoll_event ev = { .events = EPOLLIN | EPOLLRDHUP | (on ? EPOLLOUT : 0), .data.ptr = c };
+    epoll_ctl(epfd, EPOLL_CTL_MOD, c->fd, &ev);
+}
+
+void net_remove(Connection *c) {
+    // Le close() qui suit suffirait, mais on reste explicite
+    epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, NULL);
+}
+
+int net_wait(int timeout_ms) {
+    struct epoll_event events[MAX_EVENTS];
+    uint32_t gens[MAX_EVENTS];
+
+    int n = epoll_wait(epfd, events, MAX_EVENTS, timeout_ms);
+    on_events();
+    if (n < 0) return (errno == EINTR) ? 0 : -1;
+
+    // Génération de chaque connexion au réveil : si elle est fermée plus tôt dans le lot,
+    // son slot peut déjà servir à une autre connexion, à qui l'événement ne s'adresse pas
+    for (int i = 0; i < n; i++) {
+        Connection *c = events[i].data.ptr;
+        if (c != NULL && (void *)c != &wakeup_marker) gens[i] = c->gen;
+    }
+
+    for (int i = 0; i < n; i++) {
+        Connection *c = events[i].data.ptr;
+        if (c == NULL) {
+            on_accept(listen_fd);
+            continue;
+        }
+        if ((void *)c == &wakeup_marker) {
+            on_wakeup();
+            continue;
+        }
+        if (c->fd == 0 || c->gen != gens[i]) continue;
+
+        if (events[i].events & EPOLLOUT) on_writable(c);
+        if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) on_readable(c);
+    }
+    return n;
+}
@@ -0,0 +1,112 @@
+//
+// Backend poll() : parcourt tous les sockets à chaque réveil.
+// Gardé comme solution de repli et pour comparer avec epoll.
+//
+#include <stddef.h>
+#include <stdlib.h>
+#include <poll.h>
+#include <errno.h>
+#include "../include/net.h"
+#include "../include/shard.h"
+
+// Tableau pour poll() : le slot 0 est pour le serveur, le 1 pour le réveil du shard
+// Agrandi à la demande (les connexions ne gardent que leur index, il peut bouger)
+static SHARD_LOCAL struct pollfd *fds = NULL;
+static SHARD_LOCAL int fds_cap = 0;
+static SHARD_LOCAL int nfds = 0; // Nombre de sockets surveillés
+static SHARD_LOCAL int wakeup_fd = -1;
+
+const char *net_backend_name(void) {
+    return "poll";
+}
+
+// Place pour un socket de plus
+static int reserve_slot(void) {
+    if (nfds < fds_cap) return 0;
+
+    int cap = fds_cap ? fds_cap * 2 : 64;
+    struct pollfd *grown = realloc(fds, (size_t)cap * sizeof(struct pollfd));
+    if (grown == NULL) return -1;
+    fds = grown;
+    fds_cap = cap;
+    return 0;
+}
+
+int net_init(int server_fd) {
+    if (reserve_slot() < 0) return -1;
+    fds[0].fd = server_fd;
+    fds[0].events = POLLIN;
+    nfds = 1;
+    return 0;
+}
+
+int net_add_wakeup(int fd) {
+    if (reserve_slot() < 0) return -1;
+    fds[nfds].fd = fd;
+    fds[nfds].events = POLLIN;
+    wakeup_fd = fd;
+    nfds++;
+    return 0;
+}
+
+int net_add(Connection *c) {
+    if (reserve_slot() < 0) return -1;
+
+    fds[nfds].fd = c->fd;
+    fds[nfds].events = POLLIN;
+    fds[nfds].revents = 0;
+    c->backend_slot = nfds;
+    nfds++;
+    return 0;
+}
+
+int net_flush(Connection *c) {
+    return net_writev_flush(c);
+}
+
+void net_want_write(Connection *c, int on) {
+    fds[c->backend_slot].events = POLLIN | (on ? POLLOUT : 0);
+}
+
+void net_remove(Connection *c) {
+    int slot = c->backend_slot;
+
+    // On remplace par le dernier pour boucher le trou
+    nfds--;
+    fds[slot] = fds[nfds];
+    if (slot < nfds) conn_from_fd(fds[slot].fd)->backend_slot = slot;
+}
+
+int net_wait(int timeout_ms) {
+    int poll_count = poll(fds, nfds, timeout_ms);
+
+    on_events();
+    if (poll_count < 0) return (errno == EINTR) ? 0 : -1;
+
+    // Parcours des sockets actifs
+    int i = 0;
+    while (i < nfds) {
+        // Si aucun événement sur ce socket, on passe
+        if (fds[i].revents == 0) {
+            i++;
+            continue;
+        }
+
+        // Slot 0 : le serveur. Sinon la connexion se retrouve par son fd
+        int fd = fds[i].fd;
+        short revents = fds[i].revents;
+        fds[i].revents = 0;
+        if (i == 0) {
+            on_accept(fd);
+        } else if (fd == wakeup_fd) {
+            on_wakeup();
+        } else {
+            if (revents & POLLOUT) on_writable(conn_from_fd(fd));
+            if (revents & ~POLLOUT) on_readable(conn_from_fd(fd));
+        }
+
+        // Si la connexion a été retirée, le dernier slot a pris sa place : on le traite
+        if (i < nfds && fds[i].fd == fd) i++;
+    }
+    return poll_count;
+}
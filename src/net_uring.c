@@ -0,0 +1,391 @@
+//
+// Backend io_uring : accept et recv multishot, réception dans un anneau de
+// tampons fournis au noyau, envois soumis en lot au prochain io_uring_enter().
+// Un seul appel système par tour de boucle pour soumettre et attendre.
+// Appels système directs (pas de liburing).
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "../include/net.h"
+#include "../include/shard.h"
+#include "../include/log.h"
+
+#define RING_ENTRIES 4096
+#define BUF_COUNT 512   // Tampons de réception (puissance de 2)
+#define BUF_SIZE 2048
+#define BUF_GROUP 0
+#define SQ_FULL_RETRIES 4 // Soumissions tentées avant de déclarer la file bloquée
+
+// user_data : fd (32 bits) | génération (24 bits) | opération (8 bits)
+enum { OP_ACCEPT = 1, OP_RECV, OP_SEND, OP_WAKEUP, OP_IGNORE };
+#define UD(fd, gen, op) (((uint64_t)(uint32_t)(fd) << 32) | (((uint64_t)(gen) & 0xFFFFFF) << 8) | (op))
+#define UD_FD(ud) ((int)((ud) >> 32))
+#define UD_GEN(ud) ((uint32_t)(((ud) >> 8) & 0xFFFFFF))
+#define UD_OP(ud) ((int)((ud) & 0xFF))
+
+typedef struct {
+    int fd;
+    // File de soumission
+    unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+    struct io_uring_sqe *sqes;
+    unsigned sq_pending; // SQE préparées, pas encore soumises
+    // File de complétion
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_cqe *cqes;
+    // Anneau de tampons de réception
+    struct io_uring_buf_ring *buf_ring;
+    uint8_t *buffers;
+} Ring;
+
+static SHARD_LOCAL Ring ring;
+static SHARD_LOCAL int listen_fd = -1;
+static SHARD_LOCAL int wakeup_fd = -1;
+
+static int sys_setup(unsigned entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_enter(int fd, unsigned submit, unsigned min_complete, unsigned flags, void *arg, size_t argsz) {
+    return (int)syscall(__NR_io_uring_enter, fd, submit, min_complete, flags, arg, argsz);
+}
+
+static int sys_register(int fd, unsigned opcode, void *arg, unsigned nr) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr);
+}
+
+// Soumet ce qui a été préparé (sans attendre)
+static void submit_pending(void) {
+    while (ring.sq_pending > 0) {
+        int n = sys_enter(ring.fd, ring.sq_pending, 0, 0, NULL, 0);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+            log_error("Erreur io_uring_enter : %s", strerror(errno));
+            return;
+        }
+        ring.sq_pending -= (unsigned)n;
+    }
+}
+
+// Prend une SQE libre (soumet d'abord si la file est pleine, quelques fois au plus)
+// NULL : le noyau ne prend plus rien, l'appelant doit traiter l'échec
+static struct io_uring_sqe *get_sqe(void) {
+    unsigned tail = *ring.sq_tail;
+    unsigned head = atomic_load_explicit((_Atomic unsigned *)ring.sq_head, memory_order_acquire);
+
+    for (int tries = 0; tail - head > *ring.sq_mask; tries++) {
+        if (tries == SQ_FULL_RETRIES) return NULL;
+        submit_pending();
+        head = atomic_load_explicit((_Atomic unsigned *)ring.sq_head, memory_order_acquire);
+    }
+
+    unsigned idx = tail & *ring.sq_mask;
+    struct io_uring_sqe *sqe = &ring.sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    ring.sq_array[idx] = idx;
+    atomic_store_explicit((_Atomic unsigned *)ring.sq_tail, tail + 1, memory_order_release);
+    ring.sq_pending++;
+    return sqe;
+}
+
+// Rend un tampon de réception au noyau
+static void recycle_buffer(unsigned bid) {
+    struct io_uring_buf_ring *br = ring.buf_ring;
+    unsigned short tail = br->tail;
+    struct io_uring_buf *buf = &br->bufs[tail & (BUF_COUNT - 1)];
+
+    buf->addr = (uint64_t)(uintptr_t)(ring.buffers + (size_t)bid * BUF_SIZE);
+    buf->len = BUF_SIZE;
+    buf->bid = (unsigned short)bid;
+    atomic_store_explicit((_Atomic unsigned short *)&br->tail, (unsigned short)(tail + 1), memory_order_release);
+}
+
+static int arm_accept(void) {
+    struct io_uring_sqe *sqe = get_sqe();
+    if (sqe == NULL) return -1;
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = UD(listen_fd, 0, OP_ACCEPT);
+    return 0;
+}
+
+static int arm_recv(Connection *c) {
+    struct io_uring_sqe *sqe = get_sqe();
+    if (sqe == NULL) return -1;
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = c->fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUF_GROUP;
+    sqe->user_data = UD(c->fd, c->gen, OP_RECV);
+    return 0;
+}
+
+static int arm_wakeup(void) {
+    struct io_uring_sqe *sqe = get_sqe();
+    if (sqe == NULL) return -1;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = wakeup_fd;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = UD(wakeup_fd, 0, OP_WAKEUP);
+    return 0;
+}
+
+const char *net_backend_name(void) {
+    return "io_uring";
+}
+
+int net_init(int server_fd) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN;
+
+    ring.fd = sys_setup(RING_ENTRIES, &p);
+    if (ring.fd < 0 && errno == EINVAL) {
+        // Noyau plus ancien : sans les options d'optimisation
+        memset(&p, 0, sizeof(p));
+        ring.fd = sys_setup(RING_ENTRIES, &p);
+    }
+    if (ring.fd < 0) return -1;
+    if (!(p.features & IORING_FEAT_SINGLE_MMAP) || !(p.features & IORING_FEAT_EXT_ARG)) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    // Les deux files partagent un seul mmap
+    size_t sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    size_t cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    size_t ring_size = sq_size > cq_size ? sq_size : cq_size;
+
+    uint8_t *base = mmap(NULL, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ring.fd, IORING_OFF_SQ_RING);
+    if (base == MAP_FAILED) return -1;
+
+    ring.sqes = mmap(NULL, p.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQES);
+    if (ring.sqes == MAP_FAILED) return -1;
+
+    ring.sq_head = (unsigned *)(base + p.sq_off.head);
+    ring.sq_tail = (unsigned *)(base + p.sq_off.tail);
+    ring.sq_mask = (unsigned *)(base + p.sq_off.ring_mask);
+    ring.sq_array = (unsigned *)(base + p.sq_off.array);
+    ring.cq_head = (unsigned *)(base + p.cq_off.head);
+    ring.cq_tail = (unsigned *)(base + p.cq_off.tail);
+    ring.cq_mask = (unsigned *)(base + p.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe *)(base + p.cq_off.cqes);
+
+    // Anneau de tampons fournis, enregistré auprès du noyau
+    ring.buf_ring = mmap(NULL, BUF_COUNT * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ring.buffers = malloc((size_t)BUF_COUNT * BUF_SIZE);
+    if (ring.buf_ring == MAP_FAILED || ring.buffers == NULL) return -1;
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)ring.buf_ring;
+    reg.ring_entries = BUF_COUNT;
+    reg.bgid = BUF_GROUP;
+    if (sys_register(ring.fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) return -1;
+
+    ring.buf_ring->tail = 0;
+    for (unsigned i = 0; i < BUF_COUNT; i++) recycle_buffer(i);
+
+    listen_fd = server_fd;
+    return arm_accept();
+}
+
+int net_add_wakeup(int fd) {
+    wakeup_fd = fd;
+    return arm_wakeup();
+}
+
+int net_add(Connection *c) {
+    c->gen++;
+    c->tx_inflight = 0;
+    return arm_recv(c);
+}
+
+// Annule de façon synchrone tout ce qui vise ce fd, puis récupère les complétions
+// déjà postées pour cette connexion : les octets reçus restent dans c->rx
+// (utile quand la connexion part vers un autre shard), les tampons sont rendus.
+void net_remove(Connection *c) {
+    submit_pending();
+
+    struct io_uring_sync_cancel_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.fd = c->fd;
+    reg.flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    reg.timeout.tv_sec = -1;
+    reg.timeout.tv_nsec = -1;
+    if (sys_register(ring.fd, IORING_REGISTER_SYNC_CANCEL, &reg, 1) < 0 && errno != ENOENT) {
+        log_error("Erreur io_uring sync cancel : %s", strerror(errno));
+    }
+
+    unsigned head = *ring.cq_head;
+    unsigned tail = atomic_load_explicit((_Atomic unsigned *)ring.cq_tail, memory_order_acquire);
+    for (; head != tail; head++) {
+        struct io_uring_cqe *cqe = &ring.cqes[head & *ring.cq_mask];
+        int op = UD_OP(cqe->user_data);
+        if (UD_FD(cqe->user_data) != c->fd || (op != OP_RECV && op != OP_SEND)) continue;
+        if (UD_GEN(cqe->user_data) != (c->gen & 0xFFFFFF)) continue;
+
+        if (cqe->flags & IORING_CQE_F_BUFFER) {
+            unsigned bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+            if (op == OP_RECV && cqe->res > 0 && (size_t)cqe->res <= CONN_RX_SIZE - c->rx_len) {
+                memcpy(c->rx + c->rx_len, ring.buffers + (size_t)bid * BUF_SIZE, (size_t)cqe->res);
+                c->rx_len += (size_t)cqe->res;
+            }
+            recycle_buffer(bid);
+        }
+        // Déjà traitée ici : la boucle de net_wait l'ignorera
+        cqe->user_data = UD(0, 0, OP_IGNORE);
+        cqe->flags = 0;
+    }
+    c->tx_inflight = 0;
+}
+
+// Prépare un envoi du premier morceau contigu de la file ; la suite partira
+// à la complétion. Soumis au prochain io_uring_enter(), avec tout le reste du tour.
+int net_flush(Connection *c) {
+    if (c->tx_inflight > 0 || c->tx_len == 0) return 0;
+
+    uint32_t len = CONN_TX_SIZE - c->tx_head;
+    if (len > c->tx_len) len = c->tx_len;
+
+    struct io_uring_sqe *sqe = get_sqe();
+    if (sqe == NULL) return -1;
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = c->fd;
+    sqe->addr = (uint64_t)(uintptr_t)(c->tx + c->tx_head);
+    sqe->len = len;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = UD(c->fd, c->gen, OP_SEND);
+    c->tx_inflight = len;
+    return 0;
+}
+
+// Inutile ici : les envois se terminent par une complétion, pas par un réveil POLLOUT
+void net_want_write(Connection *c, int on) {
+    (void)c;
+    (void)on;
+}
+
+// Connexion visée par une complétion, NULL si elle a disparu depuis
+static Connection *conn_of(uint64_t ud) {
+    Connection *c = conn_from_fd(UD_FD(ud));
+    if (c == NULL || c->fd == 0 || (c->gen & 0xFFFFFF) != UD_GEN(ud)) return NULL;
+    return c;
+}
+
+static void handle_cqe(uint64_t ud, int res, unsigned flags) {
+    int more = (flags & IORING_CQE_F_MORE) != 0;
+    Connection *c;
+
+    switch (UD_OP(ud)) {
+        case OP_ACCEPT:
+            if (res >= 0) on_accepted(res);
+            if (!more && arm_accept() < 0) {
+                // Sans accept armé, le shard n'aurait plus jamais de nouveau client
+                log_error("io_uring : impossible de réarmer accept, arrêt.");
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        case OP_WAKEUP:
+            on_wakeup();
+            if (!more && arm_wakeup() < 0) {
+                // Sans poll sur l'eventfd, la boîte aux lettres du shard serait sourde
+                log_error("io_uring : impossible de réarmer le réveil, arrêt.");
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        case OP_RECV: {
+            c = conn_of(ud);
+            if (flags & IORING_CQE_F_BUFFER) {
+                unsigned bid = flags >> IORING_CQE_BUFFER_SHIFT;
+                // On copie dans c->rx avant de rendre le tampon
+                if (c && res > 0) on_data(c, ring.buffers + (size_t)bid * BUF_SIZE, (size_t)res);
+                recycle_buffer(bid);
+            }
+            if (c == NULL || c->fd == 0) break;
+
+            if (res == 0 || (res < 0 && res != -ENOBUFS)) {
+                on_closed(c);
+            } else if (!more && !c->closing && !c->handoff_to) {
+                // Multishot terminé (plus de tampons libres par exemple) : on réarme
+                if (arm_recv(c) < 0) {
+                    log_error("io_uring : réception non réarmée (Socket %d), fermeture.", c->fd);
+                    on_closed(c);
+                }
+            }
+            break;
+        }
+
+        case OP_SEND:
+            c = conn_of(ud);
+            if (c == NULL) break;
+            c->tx_inflight = 0;
+            if (res < 0) {
+                on_closed(c);
+                break;
+            }
+            c->tx_head = (c->tx_head + (uint32_t)res) % CONN_TX_SIZE;
+            c->tx_len -= (uint32_t)res;
+            if (c->tx_len == 0) c->tx_head = 0;
+            else if (net_flush(c) < 0) on_closed(c);
+            break;
+    }
+}
+
+int net_wait(int timeout_ms) {
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.sigmask_sz = _NSIG / 8;
+    if (timeout_ms >= 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long long)(timeout_ms % 1000) * 1000000;
+        arg.ts = (uint64_t)(uintptr_t)&ts;
+    }
+
+    // Un seul appel : soumission du lot du tour précédent + attente
+    int n = sys_enter(ring.fd, ring.sq_pending, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                      &arg, sizeof(arg));
+    if (n < 0) {
+        if (errno != EINTR && errno != ETIME && errno != EAGAIN && errno != EBUSY) return -1;
+    } else {
+        ring.sq_pending -= (unsigned)n;
+    }
+    on_events();
+
+    int count = 0;
+    while (1) {
+        unsigned head = *ring.cq_head;
+        unsigned tail = atomic_load_explicit((_Atomic unsigned *)ring.cq_tail, memory_order_acquire);
+        if (head == tail) break;
+
+        // On copie et on libère la CQE avant de la traiter : net_remove() peut
+        // parcourir les suivantes pendant le traitement
+        struct io_uring_cqe *cqe = &ring.cqes[head & *ring.cq_mask];
+        uint64_t ud = cqe->user_data;
+        int res = cqe->res;
+        unsigned flags = cqe->flags;
+        atomic_store_explicit((_Atomic unsigned *)ring.cq_head, head + 1, memory_order_release);
+
+        if (UD_OP(ud) != OP_IGNORE) handle_cqe(ud, res, flags);
+        count++;
+    }
+    return count;
+}
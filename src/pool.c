@@ -0,0 +1,55 @@
+//
+// Pools d'objets par blocs (slab) avec liste libre intrusive
+//
+#include <stdlib.h>
+#include <string.h>
+#include "../include/pool.h"
+
+int pool_init(Pool *p, size_t obj_size, uint32_t chunk, uint32_t capacity) {
+    if (chunk == 0 || capacity == 0) return -1;
+
+    uint32_t nb_chunks = (uint32_t)(((uint64_t)capacity + chunk - 1) / chunk);
+    p->obj_size = (obj_size + POOL_ALIGN - 1) & ~(size_t)(POOL_ALIGN - 1);
+    p->chunk = chunk;
+    p->capacity = capacity;
+    p->carved = 0;
+    p->live = 0;
+    p->free_head = POOL_NONE;
+    p->chunks = calloc(nb_chunks, sizeof(uint8_t *));
+    return (p->chunks == NULL) ? -1 : 0;
+}
+
+// Nouveau bloc : ses objets sont chaînés dans l'ordre (0, 1, 2... sortent en premier)
+static int pool_grow(Pool *p) {
+    if (p->carved >= p->capacity) return -1;
+
+    uint8_t *block = aligned_alloc(POOL_ALIGN, p->obj_size * p->chunk);
+    if (block == NULL) return -1;
+    memset(block, 0, p->obj_size * p->chunk);
+    p->chunks[p->carved / p->chunk] = block;
+
+    uint32_t first = p->carved;
+    p->carved += p->chunk;
+    for (uint32_t i = 0; i < p->chunk; i++) {
+        uint32_t next = (i + 1 < p->chunk) ? first + i + 1 : p->free_head;
+        memcpy(block + (size_t)i * p->obj_size, &next, sizeof(next));
+    }
+    p->free_head = first;
+    return 0;
+}
+
+uint32_t pool_alloc(Pool *p) {
+    if (p->live >= p->capacity) return POOL_NONE;
+    if (p->free_head == POOL_NONE && pool_grow(p) < 0) return POOL_NONE;
+
+    uint32_t id = p->free_head;
+    memcpy(&p->free_head, pool_at(p, id), sizeof(uint32_t));
+    p->live++;
+    return id;
+}
+
+void pool_free(Pool *p, uint32_t id) {
+    memcpy(pool_at(p, id), &p->free_head, sizeof(uint32_t));
+    p->free_head = id;
+    p->live--;
+}
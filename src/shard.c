@@ -0,0 +1,93 @@
+//
+// Threads du serveur et boîtes aux lettres inter-shards
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "../include/shard.h"
+#include "../include/log.h"
+
+int shard_count = 1;
+SHARD_LOCAL int shard_id = 0;
+
+// Boîte aux lettres : rarement utilisée (matchmaking, bot), un mutex suffit
+typedef struct {
+    pthread_mutex_t lock;
+    Handoff *head;
+    Handoff *tail;
+    int event_fd;
+} Mailbox;
+
+static Mailbox mailboxes[MAX_SHARDS];
+
+static void (*shard_entry)(int id);
+
+static void *shard_thread(void *arg) {
+    int id = (int)(intptr_t)arg;
+    shard_id = id;
+    shard_entry(id);
+    return NULL;
+}
+
+void shard_run_all(void (*run)(int id)) {
+    pthread_t threads[MAX_SHARDS];
+
+    if (shard_count < 1) shard_count = 1;
+    if (shard_count > MAX_SHARDS) shard_count = MAX_SHARDS;
+
+    for (int i = 0; i < shard_count; i++) {
+        pthread_mutex_init(&mailboxes[i].lock, NULL);
+        mailboxes[i].event_fd = -1;
+    }
+
+    shard_entry = run;
+    for (int i = 1; i < shard_count; i++) {
+        if (pthread_create(&threads[i], NULL, shard_thread, (void *)(intptr_t)i) != 0) {
+            perror("Echec pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    shard_thread((void *)0);
+
+    for (int i = 1; i < shard_count; i++) pthread_join(threads[i], NULL);
+}
+
+int shard_mailbox_open(void) {
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    mailboxes[shard_id].event_fd = fd;
+    return fd;
+}
+
+void shard_post(int target, Handoff *h) {
+    Mailbox *mb = &mailboxes[target];
+    h->next = NULL;
+
+    pthread_mutex_lock(&mb->lock);
+    if (mb->tail) mb->tail->next = h;
+    else mb->head = h;
+    mb->tail = h;
+    pthread_mutex_unlock(&mb->lock);
+
+    uint64_t one = 1;
+    if (write(mb->event_fd, &one, sizeof(one)) < 0) log_error("Erreur eventfd : %s", strerror(errno));
+}
+
+Handoff *shard_take_all(void) {
+    Mailbox *mb = &mailboxes[shard_id];
+    uint64_t count;
+
+    // Remet le compteur à zéro avant de vider la liste : aucun réveil perdu
+    if (read(mb->event_fd, &count, sizeof(count)) < 0) { /* EAGAIN : rien de neuf */ }
+
+    pthread_mutex_lock(&mb->lock);
+    Handoff *list = mb->head;
+    mb->head = mb->tail = NULL;
+    pthread_mutex_unlock(&mb->lock);
+    return list;
+}
@@ -0,0 +1,132 @@
+//
+// Fins de partie séparées : nombre de tours que chaque joueur tient dans sa région
+//
+#include <stdlib.h>
+#include "../include/solver.h"
+
+// Mémo par thread : la valeur d'une région ne dépend que de (cases libres, pion),
+// elle reste donc valable d'une partie et d'un appel à l'autre
+#define MEMO_BITS 16
+#define MEMO_SIZE (1u << MEMO_BITS)
+
+typedef struct {
+    uint64_t key;   // Cases libres | (case du pion + 1) << 48, 0 = vide
+    int value;
+} MemoEntry;
+
+typedef struct {
+    MemoEntry *memo;
+    int nodes;
+    int max_nodes;
+    int aborted;
+} Solver;
+
+static _Thread_local MemoEntry *thread_memo = NULL;
+
+static uint64_t memo_key(Bitboard free, int pos) {
+    return free | ((uint64_t)(pos + 1) << 48);
+}
+
+static MemoEntry *memo_slot(Solver *s, uint64_t key) {
+    uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+    return &s->memo[h >> (64 - MEMO_BITS)];
+}
+
+// Nombre de tours que tient le pion en pos, à lui de bouger, quand l'adversaire
+// détruit une case de la région après chacun de ses mouvements
+static int survive(Solver *s, Bitboard free, int pos) {
+    Bitboard moves = game_neighbors[pos] & free;
+    if (moves == 0) return 0;
+
+    // Budget compté par visite (mémo compris) : c'est ce qui coûte le temps
+    if (++s->nodes > s->max_nodes) {
+        s->aborted = 1;
+        return 0;
+    }
+
+    uint64_t key = memo_key(free, pos);
+    MemoEntry *e = memo_slot(s, key);
+    if (e->key == key) return e->value;
+
+    int best = 0;
+    while (moves) {
+        int to = __builtin_ctzll(moves);
+        moves &= moves - 1;
+
+        Bitboard after = (free | BB_BIT(pos)) & ~BB_BIT(to);
+        Bitboard targets = after & ~BB_ORIGINS;
+        int value;
+
+        if (targets == 0) {
+            value = 1 + survive(s, after, to);
+        } else {
+            // L'adversaire choisit la pire destruction ; les voisins du pion d'abord
+            Bitboard near = targets & game_neighbors[to];
+            Bitboard order[2] = { near, targets & ~near };
+            value = BOARD_CELLS;
+            for (int k = 0; k < 2 && value > best; k++) {
+                Bitboard t = order[k];
+                while (t && value > best) {
+                    int d = __builtin_ctzll(t);
+                    t &= t - 1;
+                    int v = 1 + survive(s, after & ~BB_BIT(d), to);
+                    if (v < value) value = v;
+                }
+            }
+        }
+        if (s->aborted) return 0;
+        if (value > best) best = value;
+    }
+
+    e->key = key;
+    e->value = best;
+    return best;
+}
+
+// Même chose quand l'adversaire détruit d'abord (joueur qui ne joue pas maintenant)
+static int survive_after_destroy(Solver *s, Bitboard free, int pos) {
+    Bitboard targets = free & ~BB_ORIGINS;
+    if (targets == 0) return survive(s, free, pos);
+
+    int value = BOARD_CELLS;
+    while (targets && !s->aborted) {
+        int d = __builtin_ctzll(targets);
+        targets &= targets - 1;
+        int v = survive(s, free & ~BB_BIT(d), pos);
+        if (v < value) value = v;
+    }
+    return value;
+}
+
+int solver_solve(const Game *g, int max_cells, int max_nodes, int *plies) {
+    if (!game_separated(g)) return 0;
+
+    int mover = g->current_turn - 1;
+    int other = mover ^ 1;
+    Bitboard region_mover = game_region(g, mover);
+    Bitboard region_other = game_region(g, other);
+    if (__builtin_popcountll(region_mover) + __builtin_popcountll(region_other) > max_cells) return 0;
+
+    if (thread_memo == NULL) {
+        thread_memo = calloc(MEMO_SIZE, sizeof(MemoEntry));
+        if (thread_memo == NULL) return 0;
+    }
+
+    Solver s = { thread_memo, 0, max_nodes, 0 };
+    int a = survive(&s, region_mover, g->pos[mover]);
+    int b = survive_after_destroy(&s, region_other, g->pos[other]);
+    if (s.aborted) return 0;
+
+    // Le joueur qui doit bouger gagne s'il tient strictement plus longtemps :
+    // l'autre est bloqué juste après son (b+1)-ième tour à lui
+    int winner = (a > b) ? mover + 1 : other + 1;
+    int left = (a > b) ? 2 * b + 1 : 2 * a;
+
+    // Le modèle suppose qu'il reste toujours une case à détruire quelque part.
+    // Chaque tour en détruit une : tout en fin de plateau, on laisse la recherche faire
+    int cells = BOARD_CELLS - 2 - __builtin_popcountll(g->destroyed); // Hors origines
+    if (left + 3 > cells) return 0;
+
+    *plies = left;
+    return winner;
+}
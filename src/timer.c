@@ -0,0 +1,151 @@
+//
+// Roue de minuteries hiérarchique (une par shard)
+//
+#include <stddef.h>
+#include "../include/timer.h"
+#include "../include/shard.h"
+
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define NO_TICK UINT64_MAX
+
+typedef struct {
+    Timer *slots[TIMER_LEVELS][WHEEL_SLOTS];
+    uint64_t occupied[TIMER_LEVELS]; // Bit s = case s non vide
+    uint64_t cur;                    // Prochain tic à traiter
+} Wheel;
+
+static SHARD_LOCAL Wheel wheel;
+
+void timer_init(uint64_t now) {
+    for (int l = 0; l < TIMER_LEVELS; l++) {
+        for (int s = 0; s < WHEEL_SLOTS; s++) wheel.slots[l][s] = NULL;
+        wheel.occupied[l] = 0;
+    }
+    wheel.cur = now / TIMER_TICK_MS;
+}
+
+// Range t d'après son échéance et le tic courant
+static void place(Timer *t) {
+    uint64_t tick = (t->deadline + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+    if (tick < wheel.cur) tick = wheel.cur;
+    // Trop loin pour la dernière roue : on s'arrête à la fin de son tour, run_tick réarmera
+    if ((tick ^ wheel.cur) >> (WHEEL_BITS * TIMER_LEVELS) != 0) {
+        tick = wheel.cur | (((uint64_t)1 << (WHEEL_BITS * TIMER_LEVELS)) - 1);
+    }
+
+    // Roue = premier groupe de 6 bits au-dessus duquel l'échéance et le tic courant coïncident
+    int level = 0;
+    while ((tick ^ wheel.cur) >> (WHEEL_BITS * (level + 1)) != 0) level++;
+
+    int slot = (int)((tick >> (WHEEL_BITS * level)) & WHEEL_MASK);
+    Timer **head = &wheel.slots[level][slot];
+    t->level = (uint8_t)level;
+    t->slot = (uint8_t)slot;
+    t->next = *head;
+    if (*head) (*head)->pprev = &t->next;
+    t->pprev = head;
+    *head = t;
+    wheel.occupied[level] |= 1ULL << slot;
+}
+
+void timer_cancel(Timer *t) {
+    if (t->pprev == NULL) return;
+
+    *t->pprev = t->next;
+    if (t->next) t->next->pprev = t->pprev;
+    if (wheel.slots[t->level][t->slot] == NULL) wheel.occupied[t->level] &= ~(1ULL << t->slot);
+    t->next = NULL;
+    t->pprev = NULL;
+}
+
+void timer_arm(Timer *t, uint64_t deadline, void (*fire)(Timer *t)) {
+    timer_cancel(t);
+    t->deadline = deadline;
+    t->fire = fire;
+    place(t);
+}
+
+// Détache toute une case (la liste est renvoyée, la case est vide)
+static Timer *take_slot(int level, int slot) {
+    Timer *list = wheel.slots[level][slot];
+    wheel.slots[level][slot] = NULL;
+    wheel.occupied[level] &= ~(1ULL << slot);
+    return list;
+}
+
+// Premier tic où la roue a quelque chose à faire (déclencher ou redescendre), NO_TICK si rien
+static uint64_t next_work_tick(void) {
+    uint64_t best = NO_TICK;
+    for (int l = 0; l < TIMER_LEVELS; l++) {
+        int shift = WHEEL_BITS * l;
+        int index = (int)((wheel.cur >> shift) & WHEEL_MASK);
+        // La case courante compte encore si son tic n'est pas passé : toujours pour la roue 0,
+        // pour les roues hautes seulement quand on est pile au début de la case (pas encore redescendue)
+        int from = (l == 0 || (wheel.cur & (((uint64_t)1 << shift) - 1)) == 0) ? index : index + 1;
+        if (from >= WHEEL_SLOTS) continue;
+
+        uint64_t ahead = wheel.occupied[l] & (~0ULL << from);
+        if (ahead == 0) continue;
+
+        uint64_t base = wheel.cur & ~(((uint64_t)1 << (shift + WHEEL_BITS)) - 1);
+        uint64_t tick = base | ((uint64_t)__builtin_ctzll(ahead) << shift);
+        if (tick < best) best = tick;
+    }
+    return best;
+}
+
+// Traite le tic courant : redescente des roues hautes, puis déclenchement
+static void run_tick(uint64_t now) {
+    uint64_t tick = wheel.cur;
+
+    for (int l = TIMER_LEVELS - 1; l >= 1; l--) {
+        if ((tick & (((uint64_t)1 << (WHEEL_BITS * l)) - 1)) != 0) continue;
+        Timer *t = take_slot(l, (int)((tick >> (WHEEL_BITS * l)) & WHEEL_MASK));
+        while (t) {
+            Timer *next = t->next;
+            place(t);
+            t = next;
+        }
+    }
+
+    // Les minuteries armées pendant les rappels partent au plus tôt au tic suivant
+    Timer *expired = take_slot(0, (int)(tick & WHEEL_MASK));
+    if (expired) expired->pprev = &expired;
+    wheel.cur = tick + 1;
+
+    // Détachement un par un : un rappel peut annuler une minuterie encore dans la liste
+    while (expired) {
+        Timer *t = expired;
+        expired = t->next;
+        if (expired) expired->pprev = &expired;
+        t->next = NULL;
+        t->pprev = NULL;
+
+        if (t->deadline > now) place(t); // Échéance lointaine ramenée en fin de roue
+        else t->fire(t);
+    }
+}
+
+void timer_advance(uint64_t now) {
+    uint64_t target = now / TIMER_TICK_MS;
+    while (wheel.cur <= target) {
+        uint64_t tick = next_work_tick();
+        if (tick > target) {
+            wheel.cur = target + 1; // Rien d'ici là : on saute directement
+            break;
+        }
+        wheel.cur = tick;
+        run_tick(now);
+    }
+}
+
+int timer_next_ms(uint64_t now) {
+    uint64_t tick = next_work_tick();
+    if (tick == NO_TICK) return -1;
+
+    uint64_t at = tick * TIMER_TICK_MS;
+    if (at <= now) return 0;
+    return (at - now > INT32_MAX) ? INT32_MAX : (int)(at - now);
+}
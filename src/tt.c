@@ -0,0 +1,80 @@
+//
+// Table de transposition sans verrou (entrées XOR-validées de 16 octets)
+//
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "../include/tt.h"
+
+// data (64 bits) : score (32) | profondeur (8) | borne (2) + âge (6) | to (8) | destroy (8)
+#define D_SCORE(d) ((int32_t)(uint32_t)((d) >> 32))
+#define D_DEPTH(d) ((int)(((d) >> 24) & 0xFF))
+#define D_BOUND(d) ((TTBound)(((d) >> 22) & 0x3))
+#define D_AGE(d)   ((unsigned)(((d) >> 16) & 0x3F))
+#define D_TO(d)    ((uint8_t)((d) >> 8))
+#define D_DEST(d)  ((uint8_t)(d))
+
+typedef struct __attribute__((aligned(16))) {
+    _Atomic uint64_t check; // hash ^ data
+    _Atomic uint64_t data;
+} TTSlot;
+
+static TTSlot *table = NULL;
+static uint64_t table_mask = 0;
+static atomic_uint table_age = 0;
+
+int tt_init(size_t size_mb) {
+    size_t count = 1;
+    while (count * 2 * sizeof(TTSlot) <= size_mb * 1024 * 1024) count *= 2;
+
+    TTSlot *t = aligned_alloc(64, count * sizeof(TTSlot));
+    if (t == NULL) return -1;
+    memset(t, 0, count * sizeof(TTSlot));
+
+    table = t;
+    table_mask = count - 1;
+    return 0;
+}
+
+void tt_new_search(void) {
+    atomic_fetch_add_explicit(&table_age, 1, memory_order_relaxed);
+}
+
+int tt_probe(uint64_t hash, TTEntry *e) {
+    if (table == NULL) return 0;
+
+    TTSlot *s = &table[hash & table_mask];
+    uint64_t data = atomic_load_explicit(&s->data, memory_order_relaxed);
+    uint64_t check = atomic_load_explicit(&s->check, memory_order_relaxed);
+    if ((check ^ data) != hash || data == 0) return 0;
+
+    e->score = D_SCORE(data);
+    e->depth = D_DEPTH(data);
+    e->bound = D_BOUND(data);
+    e->best.to = D_TO(data);
+    e->best.destroy = D_DEST(data);
+    return 1;
+}
+
+void tt_store(uint64_t hash, int depth, TTBound bound, int score, Turn best) {
+    if (table == NULL) return;
+
+    TTSlot *s = &table[hash & table_mask];
+    unsigned age = atomic_load_explicit(&table_age, memory_order_relaxed) & 0x3F;
+    uint64_t old = atomic_load_explicit(&s->data, memory_order_relaxed);
+    uint64_t old_hash = atomic_load_explicit(&s->check, memory_order_relaxed) ^ old;
+
+    // Une autre position, plus profonde et de cette recherche : on la garde
+    if (old != 0 && old_hash != hash && D_AGE(old) == age && D_DEPTH(old) > depth) return;
+    // Même position : on garde le meilleur tour connu si on n'en a pas
+    if (old_hash == hash && best.to == 0xFF) {
+        best.to = D_TO(old);
+        best.destroy = D_DEST(old);
+    }
+
+    uint64_t data = ((uint64_t)(uint32_t)score << 32) | ((uint64_t)(depth & 0xFF) << 24)
+                  | ((uint64_t)bound << 22) | ((uint64_t)age << 16)
+                  | ((uint64_t)best.to << 8) | best.destroy;
+    atomic_store_explicit(&s->check, hash ^ data, memory_order_relaxed);
+    atomic_store_explicit(&s->data, data, memory_order_relaxed);
+}
@@ -0,0 +1,197 @@
+//
+// Microbenchmarks des règles (src/game.c) sur des positions tirées avec une graine fixe
+// Usage : isola_bench [-n positions] [-s graine] [-t ms par mesure]
+// Chaque mesure est répétée ; le meilleur passage donne le ns/op (le moins perturbé).
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include "../include/game.h"
+
+#define BENCH_ROUNDS 5
+
+typedef struct {
+    Game game;     // Début de tour (PHASE_MOVE)
+    Game moved;    // Même position après un mouvement légal (PHASE_DESTROY)
+} BenchPosition;
+
+static BenchPosition *positions = NULL;
+static Player players[2];
+static int position_count = 4096;
+static volatile uint64_t sink; // Empêche le compilateur de supprimer les boucles
+
+static uint64_t next_random(uint64_t *s) {
+    // xorshift64*
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545F4914F6CDD1DULL;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Parties au hasard arrêtées après 0 à 30 tours : débuts, milieux et fins de partie
+static void make_positions(uint64_t seed) {
+    uint64_t rng = (seed + 1) * 0x9E3779B97F4A7C15ULL;
+    positions = calloc((size_t)position_count, sizeof(BenchPosition));
+    if (positions == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+
+    int i = 0;
+    while (i < position_count) {
+        Game g;
+        game_init(&g, &players[0], &players[1]);
+        int plies = (int)(next_random(&rng) % 31);
+
+        Turn turns[MAX_TURNS];
+        int n = game_gen_turns(&g, turns);
+        for (int k = 0; k < plies && n > 0; k++) {
+            game_make_turn(&g, turns[next_random(&rng) % (uint64_t)n]);
+            n = game_gen_turns(&g, turns);
+        }
+        if (n == 0) continue; // Partie finie : on retire
+
+        BenchPosition *b = &positions[i++];
+        b->game = g;
+        b->moved = g;
+        Turn t = turns[next_random(&rng) % (uint64_t)n];
+        Player *p = (g.current_turn == 1) ? g.p1 : g.p2;
+        game_apply_move(&b->moved, p, CELL_X(t.to), CELL_Y(t.to));
+    }
+}
+
+// --- Les mesures : une passe sur toutes les positions, renvoie le nombre d'opérations ---
+
+static uint64_t bench_check_move(void) {
+    uint64_t acc = 0;
+    for (int i = 0; i < position_count; i++) {
+        Game *g = &positions[i].game;
+        Player *p = (g->current_turn == 1) ? g->p1 : g->p2;
+        for (int c = 0; c < BOARD_CELLS; c++) acc += (uint64_t)game_check_move(g, p, CELL_X(c), CELL_Y(c));
+    }
+    sink += acc;
+    return (uint64_t)position_count * BOARD_CELLS;
+}
+
+static uint64_t bench_check_destroy(void) {
+    uint64_t acc = 0;
+    for (int i = 0; i < position_count; i++) {
+        Game *g = &positions[i].moved;
+        Player *p = (g->current_turn == 1) ? g->p1 : g->p2;
+        for (int c = 0; c < BOARD_CELLS; c++) acc += (uint64_t)game_check_destroy(g, p, CELL_X(c), CELL_Y(c));
+    }
+    sink += acc;
+    return (uint64_t)position_count * BOARD_CELLS;
+}
+
+static uint64_t bench_check_loss(void) {
+    uint64_t acc = 0;
+    for (int i = 0; i < position_count; i++) {
+        Game *g = &positions[i].game;
+        acc += (uint64_t)game_check_loss(g, g->p1) + (uint64_t)game_check_loss(g, g->p2);
+    }
+    sink += acc;
+    return (uint64_t)position_count * 2;
+}
+
+static uint64_t bench_check_turn(void) {
+    uint64_t acc = 0;
+    for (int i = 0; i < position_count; i++) {
+        Game *g = &positions[i].game;
+        Player *p = (g->current_turn == 1) ? g->p1 : g->p2;
+        int to = positions[i].moved.pos[g->current_turn - 1];
+        for (int c = 0; c < BOARD_CELLS; c++) acc += (uint64_t)game_check_turn(g, p, CELL_X(to), CELL_Y(to), CELL_X(c), CELL_Y(c));
+    }
+    sink += acc;
+    return (uint64_t)position_count * BOARD_CELLS;
+}
+
+static uint64_t turns_generated = 0;
+
+static uint64_t bench_gen_turns(void) {
+    Turn turns[MAX_TURNS];
+    uint64_t acc = 0;
+    for (int i = 0; i < position_count; i++) acc += (uint64_t)game_gen_turns(&positions[i].game, turns);
+    sink += acc;
+    turns_generated = acc;
+    return (uint64_t)position_count;
+}
+
+static uint64_t bench_make_unmake(void) {
+    Turn turns[MAX_TURNS];
+    uint64_t ops = 0;
+    for (int i = 0; i < position_count; i++) {
+        Game g = positions[i].game;
+        int n = game_gen_turns(&g, turns);
+        for (int k = 0; k < n; k++) {
+            TurnUndo u = game_make_turn(&g, turns[k]);
+            game_unmake_turn(&g, u);
+        }
+        sink += g.hash;
+        ops += (uint64_t)n;
+    }
+    return ops;
+}
+
+typedef struct {
+    const char *name;
+    uint64_t (*run)(void);
+} Bench;
+
+static const Bench benches[] = {
+    {"game_check_move", bench_check_move},
+    {"game_check_destroy", bench_check_destroy},
+    {"game_check_loss", bench_check_loss},
+    {"game_check_turn", bench_check_turn},
+    {"game_gen_turns (position)", bench_gen_turns},
+    {"game_make_turn + unmake", bench_make_unmake},
+};
+
+int main(int argc, char **argv) {
+    uint64_t seed = 1;
+    int budget_ms = 200;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:t:")) != -1) {
+        switch (opt) {
+            case 'n': position_count = atoi(optarg); break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            case 't': budget_ms = atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage : %s [-n positions] [-s graine] [-t ms par mesure]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (position_count < 1) position_count = 1;
+    if (budget_ms < 1) budget_ms = 1;
+
+    make_positions(seed);
+    printf("%d positions (graine %lu), %d passes de %d ms\n", position_count, (unsigned long)seed,
+           BENCH_ROUNDS, budget_ms);
+
+    for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+        double best = 0;
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            uint64_t ops = 0;
+            double start = now_s(), elapsed;
+            do {
+                ops += benches[b].run();
+                elapsed = now_s() - start;
+            } while (elapsed * 1000 < budget_ms);
+
+            double ns = elapsed * 1e9 / (double)ops;
+            if (round == 0 || ns < best) best = ns;
+        }
+        printf("%-28s %8.2f ns/op\n", benches[b].name, best);
+    }
+    printf("game_gen_turns : %.1f tours par position en moyenne\n", (double)turns_generated / position_count);
+    return 0;
+}
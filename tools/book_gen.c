@@ -0,0 +1,135 @@
+//
+// Génère le livre d'ouvertures (voir include/book.h)
+// Usage : isola_book [-p tours] [-d profondeur] [-m ms] [-j threads] [-o fichier]
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/book.h"
+#include "../include/engine.h"
+#include "../include/tt.h"
+
+typedef struct {
+    Game *items;
+    size_t len;
+    size_t cap;
+} PositionList;
+
+static void push_position(PositionList *l, const Game *g) {
+    if (l->len == l->cap) {
+        l->cap = l->cap ? l->cap * 2 : 1024;
+        l->items = realloc(l->items, l->cap * sizeof(Game));
+        if (l->items == NULL) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    l->items[l->len++] = *g;
+}
+
+// Toutes les positions atteintes après moins de plies tours (partie pas finie)
+static void collect(PositionList *l, Game *g, int plies) {
+    push_position(l, g);
+    if (plies <= 1) return;
+
+    Turn turns[MAX_TURNS];
+    int n = game_gen_turns(g, turns);
+    for (int i = 0; i < n; i++) {
+        TurnUndo u = game_make_turn(g, turns[i]);
+        if (!game_turn_winner(g)) collect(l, g, plies - 1);
+        game_unmake_turn(g, u);
+    }
+}
+
+static int by_hash(const void *a, const void *b) {
+    uint64_t x = ((const Game *)a)->hash;
+    uint64_t y = ((const Game *)b)->hash;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+    int plies = 2;
+    SearchLimits limits = { 4, 0, 1 };
+    const char *path = "isola.book";
+
+    int opt;
+    while ((opt = getopt(argc, argv, "p:d:m:j:o:")) != -1) {
+        switch (opt) {
+            case 'p': plies = atoi(optarg); break;
+            case 'd': limits.max_depth = atoi(optarg); break;
+            case 'm': limits.time_ms = atoi(optarg); break;
+            case 'j': limits.threads = atoi(optarg); break;
+            case 'o': path = optarg; break;
+            default:
+                fprintf(stderr, "Usage : %s [-p tours] [-d profondeur] [-m ms] [-j threads] [-o fichier]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (tt_init(256) < 0) {
+        perror("Echec allocation table de transposition");
+        return EXIT_FAILURE;
+    }
+
+    // 1. Positions depuis le départ fixe de game_init, sans doublons
+    Player p1, p2;
+    Game start;
+    memset(&p1, 0, sizeof(p1));
+    memset(&p2, 0, sizeof(p2));
+    game_init(&start, &p1, &p2);
+    start.p1 = NULL;
+    start.p2 = NULL;
+
+    PositionList list = { NULL, 0, 0 };
+    collect(&list, &start, plies);
+    qsort(list.items, list.len, sizeof(Game), by_hash);
+
+    size_t unique = 0;
+    for (size_t i = 0; i < list.len; i++) {
+        if (unique == 0 || list.items[i].hash != list.items[unique - 1].hash) list.items[unique++] = list.items[i];
+    }
+    fprintf(stderr, "%zu positions (%zu avant dédoublonnage)\n", unique, list.len);
+
+    // 2. Recherche de chaque position, les enregistrements sortent déjà triés
+    BookRecord *records = calloc(unique ? unique : 1, sizeof(BookRecord));
+    if (records == NULL) {
+        perror("calloc");
+        return EXIT_FAILURE;
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < unique; i++) {
+        SearchResult r;
+        if (!engine_search(&list.items[i], &limits, &r)) continue;
+
+        BookRecord *rec = &records[count++];
+        rec->hash = list.items[i].hash;
+        rec->to = r.best.to;
+        rec->destroy = r.best.destroy;
+        rec->depth = (uint8_t)r.depth;
+        rec->score = r.score;
+        if (r.score >= SCORE_WIN - 1000 || r.score <= -(SCORE_WIN - 1000)) rec->flags |= BOOK_SOLVED;
+
+        if ((i + 1) % 100 == 0) fprintf(stderr, "%zu / %zu\n", i + 1, unique);
+    }
+
+    // 3. Écriture
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    BookHeader h;
+    memcpy(h.magic, BOOK_MAGIC, 4);
+    h.version = BOOK_VERSION;
+    h.count = count;
+    if (fwrite(&h, sizeof(h), 1, f) != 1 || fwrite(records, sizeof(BookRecord), count, f) != count || fclose(f) != 0) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+
+    printf("%s : %zu positions\n", path, count);
+    free(records);
+    free(list.items);
+    return 0;
+}
@@ -0,0 +1,459 @@
+//
+// Générateur de charge : des milliers de clients simulés contre le serveur Isola
+// Usage : isola_loadgen [-h hôte] [-p port] [-n clients] [-j threads] [-R connexions/s]
+//                       [-d réflexion ms] [-g parties par client] [-T secondes] [-a random|first] [-s graine]
+// Chaque client se connecte, envoie REQ_LOGIN, joue ses parties en REQ_TURN (tours légaux tirés sur
+// sa copie locale du plateau) et se remet en file après NOTIF_GAME_OVER.
+// Le serveur doit accepter assez de clients : option -c du serveur (par shard).
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include "../include/config.h"
+#include "../include/protocol.h"
+#include "../include/game.h"
+#include "../include/histogram.h"
+
+// --- Clients simulés ---
+
+typedef enum { CL_CONNECTING, CL_LOBBY, CL_INGAME, CL_DONE } ClientState;
+
+typedef enum { PICK_RANDOM, PICK_FIRST } PickMode;
+
+typedef struct {
+    int fd;
+    int index;
+    ClientState state;
+    int side;           // 1 ou 2 dans la partie en cours
+    int games;          // Parties terminées
+    Game game;          // Copie locale du plateau
+    Player me, opp;     // Pour game_init()
+    int opp_move;       // Mouvement adverse en attente de sa destruction (bot), -1 si aucun
+    int scheduled;      // Déjà dans la file des tours à jouer
+    uint64_t sent_at;   // Envoi du REQ_TURN en cours (µs), 0 si aucun
+    size_t rx_len;
+    uint8_t rx[sizeof(GameMessage) * 4];
+} SimClient;
+
+// Tours à jouer plus tard (même délai pour tous : une simple file suffit)
+typedef struct {
+    SimClient *client;
+    uint64_t due;       // µs
+} PendingTurn;
+
+typedef struct {
+    int id;
+    int epfd;
+    uint64_t rng;
+    SimClient *clients;
+    int count;
+    PendingTurn *pending; // Anneau de count cases : un tour en attente par client au plus
+    int pending_head, pending_len;
+
+    // Statistiques
+    uint64_t connected, failed, turns, games, errors;
+    uint64_t connect_done_us;  // Dernière connexion établie
+    Histogram turn_latency;    // REQ_TURN -> NOTIF_TURN de confirmation
+    Histogram connect_latency; // connect() -> connexion établie
+} LoadWorker;
+
+static struct sockaddr_in server_addr;
+static int client_count = 1000;
+static int worker_count = 1;
+static int connect_rate = 0;    // Connexions/s (0 = au plus vite)
+static int think_ms = 0;
+static int games_per_client = 0; // 0 = jusqu'à la fin de la mesure
+static PickMode pick_mode = PICK_RANDOM;
+static atomic_int stop = 0;
+static atomic_int clients_done = 0;
+static uint64_t start_us = 0;
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static uint64_t next_random(uint64_t *s) {
+    // xorshift64*
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545F4914F6CDD1DULL;
+}
+
+static int send_message(SimClient *c, int type, int v1, int v2, int v3, const char *text) {
+    GameMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = type;
+    msg.val1 = v1;
+    msg.val2 = v2;
+    msg.val3 = v3;
+    if (text) strncpy(msg.text, text, sizeof(msg.text) - 1);
+
+    // 84 octets : le tampon d'envoi du noyau suffit toujours, sinon le client est perdu
+    ssize_t n = send(c->fd, &msg, sizeof(msg), MSG_NOSIGNAL);
+    return (n == (ssize_t)sizeof(msg)) ? 0 : -1;
+}
+
+static void finish_client(LoadWorker *w, SimClient *c, int failed) {
+    if (c->state == CL_DONE) return;
+    if (failed) w->errors++;
+    epoll_ctl(w->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->state = CL_DONE;
+    atomic_fetch_add(&clients_done, 1);
+}
+
+static void login(LoadWorker *w, SimClient *c) {
+    char name[32];
+    snprintf(name, sizeof(name), "lg%d_%d", w->id, c->index);
+    if (send_message(c, REQ_LOGIN, 0, 0, 0, name) < 0) finish_client(w, c, 1);
+}
+
+static void schedule_turn(LoadWorker *w, SimClient *c) {
+    if (c->scheduled) return;
+    c->scheduled = 1;
+    int slot = (w->pending_head + w->pending_len) % w->count;
+    w->pending[slot].client = c;
+    w->pending[slot].due = now_us() + (uint64_t)think_ms * 1000;
+    w->pending_len++;
+}
+
+static void play_turn(LoadWorker *w, SimClient *c) {
+    if (c->state != CL_INGAME || c->game.current_turn != c->side || c->sent_at != 0) return;
+
+    Turn turns[MAX_TURNS];
+    int n = game_gen_turns(&c->game, turns);
+    if (n == 0) return; // Bloqué : le serveur annonce la fin de partie
+
+    Turn t = (pick_mode == PICK_FIRST) ? turns[0] : turns[next_random(&w->rng) % (uint64_t)n];
+    c->sent_at = now_us();
+    if (send_message(c, REQ_TURN, CELL_X(t.to), CELL_Y(t.to), t.destroy, NULL) < 0) finish_client(w, c, 1);
+}
+
+// Tour (le nôtre confirmé ou celui de l'adversaire) appliqué à la copie locale
+static void apply_turn(LoadWorker *w, SimClient *c, int to, int destroy) {
+    Turn t = { (uint8_t)to, (uint8_t)destroy };
+    game_make_turn(&c->game, t);
+    if (c->game.current_turn == c->side) schedule_turn(w, c);
+}
+
+static void handle_message(LoadWorker *w, SimClient *c, const GameMessage *m) {
+    switch (m->type) {
+        case NOTIF_GAME_START:
+            c->side = m->val1;
+            c->state = CL_INGAME;
+            c->opp_move = -1;
+            c->sent_at = 0;
+            game_init(&c->game, &c->me, &c->opp);
+            if (c->side == 1) schedule_turn(w, c);
+            break;
+
+        case NOTIF_TURN:
+            if (c->state != CL_INGAME) break;
+            if (c->game.current_turn == c->side) {
+                // Confirmation de notre tour
+                if (c->sent_at) hist_add(&w->turn_latency, now_us() - c->sent_at);
+                c->sent_at = 0;
+                w->turns++;
+            }
+            apply_turn(w, c, CELL_INDEX(m->val1, m->val2), m->val3);
+            break;
+
+        case NOTIF_OPP_MOVE: // Adversaire en deux messages (bot)
+            c->opp_move = CELL_INDEX(m->val1, m->val2);
+            break;
+
+        case NOTIF_DESTROY:
+            if (c->state == CL_INGAME && c->opp_move >= 0 && c->game.current_turn != c->side) {
+                apply_turn(w, c, c->opp_move, CELL_INDEX(m->val1, m->val2));
+                c->opp_move = -1;
+            }
+            break;
+
+        case RES_MOVE_ERR:
+            // Copie locale désynchronisée : on abandonne ce client
+            finish_client(w, c, 1);
+            break;
+
+        case NOTIF_GAME_OVER:
+            c->state = CL_LOBBY;
+            c->sent_at = 0;
+            c->games++;
+            w->games++;
+            if (games_per_client > 0 && c->games >= games_per_client) finish_client(w, c, 0);
+            else login(w, c); // Remise en file (sans effet si le serveur l'a déjà fait, option -r)
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void on_readable(LoadWorker *w, SimClient *c) {
+    while (c->state != CL_DONE) {
+        ssize_t n = recv(c->fd, c->rx + c->rx_len, sizeof(c->rx) - c->rx_len, 0);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return;
+        if (n <= 0) {
+            finish_client(w, c, !atomic_load(&stop));
+            return;
+        }
+        c->rx_len += (size_t)n;
+
+        size_t off = 0;
+        while (c->rx_len - off >= sizeof(GameMessage) && c->state != CL_DONE) {
+            GameMessage m;
+            memcpy(&m, c->rx + off, sizeof(m));
+            off += sizeof(m);
+            handle_message(w, c, &m);
+        }
+        c->rx_len -= off;
+        if (off > 0 && c->rx_len > 0) memmove(c->rx, c->rx + off, c->rx_len);
+    }
+}
+
+static void start_connect(LoadWorker *w, SimClient *c, uint64_t *connect_started) {
+    c->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (c->fd < 0) {
+        c->state = CL_DONE;
+        w->failed++;
+        atomic_fetch_add(&clients_done, 1);
+        return;
+    }
+    int one = 1;
+    setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    c->state = CL_CONNECTING;
+    *connect_started = now_us();
+    if (connect(c->fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0 && errno != EINPROGRESS) {
+        close(c->fd);
+        c->state = CL_DONE;
+        w->failed++;
+        atomic_fetch_add(&clients_done, 1);
+        return;
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT;
+    ev.data.ptr = c;
+    epoll_ctl(w->epfd, EPOLL_CTL_ADD, c->fd, &ev);
+}
+
+static void on_connected(LoadWorker *w, SimClient *c, uint64_t started) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err != 0) {
+        epoll_ctl(w->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+        close(c->fd);
+        c->state = CL_DONE;
+        w->failed++;
+        atomic_fetch_add(&clients_done, 1);
+        return;
+    }
+
+    uint64_t now = now_us();
+    hist_add(&w->connect_latency, now - started);
+    w->connected++;
+    w->connect_done_us = now;
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = c;
+    epoll_ctl(w->epfd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->state = CL_LOBBY;
+    login(w, c);
+}
+
+static void *worker_thread(void *arg) {
+    LoadWorker *w = arg;
+    struct epoll_event events[256];
+    uint64_t *connect_started = calloc((size_t)w->count, sizeof(uint64_t));
+    int next_connect = 0;
+
+    while (!atomic_load(&stop)) {
+        uint64_t now = now_us();
+
+        // Ouverture des connexions, au rythme demandé (réparti entre les threads)
+        while (next_connect < w->count) {
+            if (connect_rate > 0) {
+                uint64_t allowed = (now - start_us) * (uint64_t)connect_rate / 1000000 / (uint64_t)worker_count + 1;
+                if ((uint64_t)next_connect >= allowed) break;
+            }
+            SimClient *c = &w->clients[next_connect];
+            start_connect(w, c, &connect_started[next_connect]);
+            next_connect++;
+            if (connect_rate == 0 && next_connect % 64 == 0) break; // Laisser respirer la boucle
+        }
+
+        // Tours dont le temps de réflexion est écoulé
+        while (w->pending_len > 0 && w->pending[w->pending_head].due <= now) {
+            SimClient *c = w->pending[w->pending_head].client;
+            w->pending_head = (w->pending_head + 1) % w->count;
+            w->pending_len--;
+            c->scheduled = 0;
+            play_turn(w, c);
+        }
+
+        int timeout = 10;
+        if (w->pending_len > 0) {
+            uint64_t due = w->pending[w->pending_head].due;
+            timeout = (due > now) ? (int)((due - now + 999) / 1000) : 0;
+            if (timeout > 10) timeout = 10;
+        }
+        if (next_connect < w->count) timeout = (connect_rate > 0) ? 1 : 0;
+
+        int n = epoll_wait(w->epfd, events, 256, timeout);
+        for (int i = 0; i < n; i++) {
+            SimClient *c = events[i].data.ptr;
+            if (c->state == CL_CONNECTING) {
+                if (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) on_connected(w, c, connect_started[c->index]);
+            } else if (c->state != CL_DONE) {
+                on_readable(w, c);
+            }
+        }
+    }
+
+    for (int i = 0; i < w->count; i++) {
+        if (w->clients[i].state != CL_DONE && i < next_connect) close(w->clients[i].fd);
+    }
+    free(connect_started);
+    return NULL;
+}
+
+static void print_latency(const char *name, const Histogram *h) {
+    printf("%s (µs) : p50 %lu | p99 %lu | p999 %lu | max %lu (%lu mesures)\n", name,
+           (unsigned long)hist_quantile(h, 0.50), (unsigned long)hist_quantile(h, 0.99),
+           (unsigned long)hist_quantile(h, 0.999), (unsigned long)h->max, (unsigned long)h->total);
+}
+
+int main(int argc, char **argv) {
+    const char *host = "127.0.0.1";
+    int port = PORT;
+    int seconds = 10;
+    uint64_t seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:n:j:R:d:g:T:a:s:")) != -1) {
+        switch (opt) {
+            case 'h': host = optarg; break;
+            case 'p': port = atoi(optarg); break;
+            case 'n': client_count = atoi(optarg); break;
+            case 'j': worker_count = atoi(optarg); break;
+            case 'R': connect_rate = atoi(optarg); break;
+            case 'd': think_ms = atoi(optarg); break;
+            case 'g': games_per_client = atoi(optarg); break;
+            case 'T': seconds = atoi(optarg); break;
+            case 'a':
+                if (strcmp(optarg, "random") == 0) pick_mode = PICK_RANDOM;
+                else if (strcmp(optarg, "first") == 0) pick_mode = PICK_FIRST;
+                else {
+                    fprintf(stderr, "Mode de jeu inconnu : %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            default:
+                fprintf(stderr, "Usage : %s [-h hôte] [-p port] [-n clients] [-j threads] [-R connexions/s]\n"
+                                "          [-d réflexion ms] [-g parties par client] [-T secondes] [-a random|first] [-s graine]\n",
+                        argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (client_count < 1) client_count = 1;
+    if (worker_count < 1) worker_count = 1;
+    if (worker_count > client_count) worker_count = client_count;
+
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host, &server_addr.sin_addr) != 1) {
+        fprintf(stderr, "Adresse invalide : %s\n", host);
+        return EXIT_FAILURE;
+    }
+
+    // Un fd par client simulé
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < (rlim_t)client_count + 64) {
+        rl.rlim_cur = (rl.rlim_max == RLIM_INFINITY || rl.rlim_max > (rlim_t)client_count + 64)
+                          ? (rlim_t)client_count + 64 : rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    LoadWorker *workers = calloc((size_t)worker_count, sizeof(LoadWorker));
+    SimClient *clients = calloc((size_t)client_count, sizeof(SimClient));
+    pthread_t *threads = calloc((size_t)worker_count, sizeof(pthread_t));
+    if (!workers || !clients || !threads) {
+        perror("calloc");
+        return EXIT_FAILURE;
+    }
+
+    // Clients découpés en blocs contigus, un par thread
+    for (int i = 0; i < worker_count; i++) {
+        LoadWorker *w = &workers[i];
+        int lo = (int)((int64_t)client_count * i / worker_count);
+        int hi = (int)((int64_t)client_count * (i + 1) / worker_count);
+        w->id = i;
+        w->clients = clients + lo;
+        w->count = hi - lo;
+        w->pending = calloc((size_t)w->count, sizeof(PendingTurn));
+        w->rng = (seed + 1) * 0x9E3779B97F4A7C15ULL ^ (uint64_t)(i + 1) * 0xBF58476D1CE4E5B9ULL;
+        w->epfd = epoll_create1(EPOLL_CLOEXEC);
+        if (w->pending == NULL || w->epfd < 0) {
+            perror("Echec init thread");
+            return EXIT_FAILURE;
+        }
+        for (int j = 0; j < w->count; j++) w->clients[j].index = j;
+    }
+
+    printf("%d clients, %d threads -> %s:%d, réflexion %d ms, %s\n", client_count, worker_count, host, port,
+           think_ms, pick_mode == PICK_FIRST ? "premier tour légal" : "tours au hasard");
+
+    start_us = now_us();
+    for (int i = 0; i < worker_count; i++) pthread_create(&threads[i], NULL, worker_thread, &workers[i]);
+
+    // Fin : durée écoulée, ou tous les clients ont fini leurs parties (-g)
+    uint64_t deadline = start_us + (uint64_t)seconds * 1000000;
+    while (now_us() < deadline && atomic_load(&clients_done) < client_count) usleep(10000);
+    atomic_store(&stop, 1);
+    for (int i = 0; i < worker_count; i++) pthread_join(threads[i], NULL);
+    double elapsed = (double)(now_us() - start_us) / 1e6;
+
+    // Statistiques
+    uint64_t connected = 0, failed = 0, turns = 0, games = 0, errors = 0, last_connect = start_us;
+    Histogram *turn_latency = calloc(1, sizeof(Histogram));
+    Histogram *connect_latency = calloc(1, sizeof(Histogram));
+    for (int i = 0; i < worker_count; i++) {
+        LoadWorker *w = &workers[i];
+        connected += w->connected;
+        failed += w->failed;
+        turns += w->turns;
+        games += w->games;
+        errors += w->errors;
+        if (w->connect_done_us > last_connect) last_connect = w->connect_done_us;
+        hist_merge(turn_latency, &w->turn_latency);
+        hist_merge(connect_latency, &w->connect_latency);
+    }
+
+    double connect_s = (double)(last_connect - start_us) / 1e6;
+    printf("Connexions : %lu établies, %lu échouées en %.3f s (%.0f connexions/s)\n", (unsigned long)connected,
+           (unsigned long)failed, connect_s, connect_s > 0 ? (double)connected / connect_s : 0.0);
+    printf("%.3f s : %lu parties (%.1f/s), %lu tours (%.0f tours/s), %lu clients en erreur\n", elapsed,
+           (unsigned long)games, (double)games / elapsed, (unsigned long)turns, (double)turns / elapsed,
+           (unsigned long)errors);
+    print_latency("Latence connexion", connect_latency);
+    print_latency("Latence tour", turn_latency);
+    return (errors > 0) ? EXIT_FAILURE : 0;
+}
@@ -0,0 +1,130 @@
+//
+// Perft : nombre de suites de tours légaux (mouvement + destruction) depuis la position de départ
+// Usage : isola_perft [-d profondeur] [-r] [-v]
+//   -r : recompte aussi avec les règles du serveur (game_check_move / game_check_destroy),
+//        case par case, et vérifie que les deux comptes et les empreintes Zobrist concordent
+//   -v : détail par premier tour (divide)
+// Toute nouvelle représentation du plateau doit redonner exactement les mêmes nombres.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include "../include/game.h"
+
+// Générateur rapide : game_gen_turns + make / unmake
+static uint64_t perft(Game *g, int depth) {
+    Turn turns[MAX_TURNS];
+    int n = game_gen_turns(g, turns);
+    if (depth == 1) return (uint64_t)n;
+
+    uint64_t nodes = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t hash = g->hash;
+        TurnUndo u = game_make_turn(g, turns[i]);
+        nodes += perft(g, depth - 1);
+        game_unmake_turn(g, u);
+        if (g->hash != hash) {
+            fprintf(stderr, "Empreinte différente après unmake (profondeur %d)\n", depth);
+            exit(EXIT_FAILURE);
+        }
+    }
+    return nodes;
+}
+
+// Référence lente : toutes les cases essayées avec les fonctions de règles du serveur
+static uint64_t perft_rules(const Game *g, int depth) {
+    Player *p = (g->current_turn == 1) ? g->p1 : g->p2;
+    uint64_t nodes = 0;
+
+    for (int y = 0; y < BOARD_HEIGHT; y++) {
+        for (int x = 0; x < BOARD_WIDTH; x++) {
+            Game moved = *g;
+            if (!game_check_move(&moved, p, x, y)) continue;
+            game_apply_move(&moved, p, x, y);
+
+            for (int dy = 0; dy < BOARD_HEIGHT; dy++) {
+                for (int dx = 0; dx < BOARD_WIDTH; dx++) {
+                    if (!game_check_destroy(&moved, p, dx, dy)) continue;
+                    if (!game_check_turn((Game *)g, p, x, y, dx, dy)) {
+                        fprintf(stderr, "game_check_turn refuse (%d,%d)+(%d,%d)\n", x, y, dx, dy);
+                        exit(EXIT_FAILURE);
+                    }
+                    if (depth == 1) {
+                        nodes++;
+                        continue;
+                    }
+                    Game after = moved;
+                    game_apply_destroy(&after, dx, dy);
+                    if (after.hash != game_compute_hash(&after)) {
+                        fprintf(stderr, "Empreinte incrémentale fausse après (%d,%d)+(%d,%d)\n", x, y, dx, dy);
+                        exit(EXIT_FAILURE);
+                    }
+                    nodes += perft_rules(&after, depth - 1);
+                }
+            }
+        }
+    }
+    return nodes;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    int max_depth = 3;
+    int reference = 0;
+    int divide = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:rv")) != -1) {
+        switch (opt) {
+            case 'd': max_depth = atoi(optarg); break;
+            case 'r': reference = 1; break;
+            case 'v': divide = 1; break;
+            default:
+                fprintf(stderr, "Usage : %s [-d profondeur] [-r] [-v]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (max_depth < 1) max_depth = 1;
+
+    Player p1, p2;
+    Game g;
+    memset(&p1, 0, sizeof(p1));
+    memset(&p2, 0, sizeof(p2));
+    game_init(&g, &p1, &p2);
+
+    int failed = 0;
+    for (int depth = 1; depth <= max_depth; depth++) {
+        double start = now_s();
+        uint64_t nodes = perft(&g, depth);
+        double elapsed = now_s() - start;
+        printf("perft(%d) = %lu  (%.3f s, %.1f M tours/s)", depth, (unsigned long)nodes, elapsed,
+               elapsed > 0 ? (double)nodes / elapsed / 1e6 : 0.0);
+
+        if (reference) {
+            uint64_t expected = perft_rules(&g, depth);
+            printf("  règles : %lu %s", (unsigned long)expected, expected == nodes ? "OK" : "DIFFÉRENT");
+            if (expected != nodes) failed = 1;
+        }
+        printf("\n");
+    }
+
+    if (divide) {
+        Turn turns[MAX_TURNS];
+        int n = game_gen_turns(&g, turns);
+        for (int i = 0; i < n; i++) {
+            TurnUndo u = game_make_turn(&g, turns[i]);
+            uint64_t nodes = (max_depth > 1) ? perft(&g, max_depth - 1) : 1;
+            game_unmake_turn(&g, u);
+            printf("(%d,%d)+(%d,%d) : %lu\n", CELL_X(turns[i].to), CELL_Y(turns[i].to),
+                   CELL_X(turns[i].destroy), CELL_Y(turns[i].destroy), (unsigned long)nodes);
+        }
+    }
+    return failed ? EXIT_FAILURE : 0;
+}
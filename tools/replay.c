@@ -0,0 +1,306 @@
+//
+// Relecture du journal des parties (voir include/journal.h) : chaque coup repasse par les règles de game.c
+// Usage : isola_replay [-g] [-d] [-v] fichier.isj...
+//   -g : une ligne par partie terminée (shard, partie, joueurs, cotes, gagnant, fin, tours, durée)
+//   -d : fait aussi confirmer chaque fin "décidée" par le solveur (lent : jusqu'à quelques ms par partie)
+//   -v : détail de chaque anomalie
+// Les segments d'un même shard doivent être donnés dans l'ordre (une partie peut être à cheval).
+// Contrôles : chaque coup est légal, chaque fin "bloqué" laisse bien le perdant sans tour.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../include/game.h"
+#include "../include/journal.h"
+#include "../include/solver.h"
+#include "../include/shard.h"
+
+typedef struct {
+    int open;
+    int broken;      // Coup illégal : la suite de la partie est ignorée
+    Game game;
+    Player players[2];
+    int rating[2];
+    uint32_t turns;
+    uint64_t started_ms;
+} ReplayGame;
+
+// Parties en cours du shard relu, par numéro de slot
+typedef struct {
+    ReplayGame **games;
+    uint32_t size;
+} ShardGames;
+
+static ShardGames shards[MAX_SHARDS];
+static int print_games = 0;
+static int verbose = 0;
+static int check_decided = 0;
+
+// Totaux
+static uint64_t records = 0, bytes = 0, turns = 0;
+static uint64_t started = 0, finished = 0, wins[3] = {0, 0, 0}, reasons[JOURNAL_END_FORFEIT + 1];
+static uint64_t illegal = 0, bad_end = 0, orphans = 0, truncated = 0, unchecked = 0;
+
+static const char *reason_names[] = {"?", "bloqué", "décidée", "temps", "forfait"};
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static ReplayGame *game_of(int shard, uint32_t id) {
+    ShardGames *s = &shards[shard];
+    if (id >= s->size) {
+        uint32_t size = s->size ? s->size : 64;
+        while (size <= id) size *= 2;
+        ReplayGame **grown = realloc(s->games, size * sizeof(ReplayGame *));
+        if (grown == NULL) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+        memset(grown + s->size, 0, (size - s->size) * sizeof(ReplayGame *));
+        s->games = grown;
+        s->size = size;
+    }
+    if (s->games[id] == NULL && (s->games[id] = calloc(1, sizeof(ReplayGame))) == NULL) {
+        perror("calloc");
+        exit(EXIT_FAILURE);
+    }
+    return s->games[id];
+}
+
+static void anomaly(uint64_t *counter, const char *file, size_t off, uint32_t id, const char *what) {
+    (*counter)++;
+    if (verbose) fprintf(stderr, "%s+%lu : partie %u : %s\n", file, (unsigned long)off, id, what);
+}
+
+// Joueur au trait, NULL si la partie n'est pas jouable
+static Player *to_play(ReplayGame *r) {
+    if (!r->open || r->broken) return NULL;
+    return (r->game.current_turn == 1) ? r->game.p1 : r->game.p2;
+}
+
+static void replay_end(ReplayGame *r, const JournalEnd *e, int shard, const char *file, size_t off) {
+    Player *loser = (e->winner == 1) ? r->game.p2 : r->game.p1;
+    if (e->reason == JOURNAL_END_BLOCKED && !game_check_loss(&r->game, loser)) {
+        anomaly(&bad_end, file, off, e->game, "fin \"bloqué\" mais le perdant peut encore jouer");
+    } else if (e->reason == JOURNAL_END_DECIDED && check_decided) {
+        // Budget de nœuds dépassé (sa mémoire n'est pas celle du serveur) : ni oui ni non
+        int plies;
+        int winner = solver_solve(&r->game, SOLVER_SERVER_CELLS, SOLVER_MAX_NODES, &plies);
+        if (winner == 0) unchecked++;
+        else if (winner != e->winner) anomaly(&bad_end, file, off, e->game, "fin \"décidée\" contredite par le solveur");
+    }
+
+    finished++;
+    if (e->winner <= 2) wins[e->winner]++;
+    if (e->reason <= JOURNAL_END_FORFEIT) reasons[e->reason]++;
+    if (print_games) {
+        printf("%d %u %s %s %d %d %u %s %u %lu\n", shard, e->game, r->players[0].username,
+               r->players[1].username, r->rating[0], r->rating[1], e->winner,
+               reason_names[e->reason <= JOURNAL_END_FORFEIT ? e->reason : 0], r->turns,
+               (unsigned long)(e->time_ms - r->started_ms));
+    }
+    r->open = 0;
+}
+
+// Relit un segment projeté en mémoire. Renvoie -1 s'il n'est pas lisible
+static int replay_file(const char *file) {
+    int fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        perror(file);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(JournalHeader)) {
+        fprintf(stderr, "%s : pas un journal\n", file);
+        close(fd);
+        return -1;
+    }
+    size_t size = (size_t)st.st_size;
+    const uint8_t *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    madvise((void *)data, size, MADV_SEQUENTIAL);
+
+    JournalHeader h;
+    memcpy(&h, data, sizeof(h));
+    if (memcmp(h.magic, JOURNAL_MAGIC, 4) != 0 || h.version != JOURNAL_VERSION || h.shard >= MAX_SHARDS) {
+        fprintf(stderr, "%s : en-tête invalide\n", file);
+        munmap((void *)data, size);
+        return -1;
+    }
+    int shard = h.shard;
+
+    size_t off = sizeof(h);
+    while (off < size) {
+        uint8_t type = data[off];
+        size_t need = 0;
+        switch (type) {
+            case JOURNAL_START:
+                need = sizeof(JournalStart);
+                if (off + need <= size) {
+                    const JournalStart *s = (const JournalStart *)(data + off);
+                    need += (size_t)s->name_len[0] + s->name_len[1];
+                }
+                break;
+            case JOURNAL_MOVE:
+            case JOURNAL_DESTROY: need = sizeof(JournalCell); break;
+            case JOURNAL_TURN: need = sizeof(JournalTurn); break;
+            case JOURNAL_END: need = sizeof(JournalEnd); break;
+            default:
+                fprintf(stderr, "%s+%lu : type %u inconnu, fin de la relecture du fichier\n", file,
+                        (unsigned long)off, type);
+                munmap((void *)data, size);
+                return -1;
+        }
+        if (off + need > size) {
+            truncated++; // Écriture interrompue (arrêt du serveur) : le reste est perdu
+            break;
+        }
+
+        const uint8_t *rec = data + off;
+        uint32_t id;
+        memcpy(&id, rec + 1, sizeof(id));
+        ReplayGame *r = game_of(shard, id);
+        Player *p = to_play(r);
+
+        switch (type) {
+            case JOURNAL_START: {
+                const JournalStart *s = (const JournalStart *)rec;
+                if (r->open) anomaly(&orphans, file, off, id, "nouvelle partie sur un slot sans fin");
+                memset(r, 0, sizeof(*r));
+                r->open = 1;
+                r->started_ms = s->time_ms;
+                const char *names = (const char *)rec + sizeof(JournalStart);
+                for (int i = 0; i < 2; i++) {
+                    size_t len = s->name_len[i] < 31 ? s->name_len[i] : 31;
+                    memcpy(r->players[i].username, names, len);
+                    names += s->name_len[i];
+                    r->rating[i] = s->rating[i];
+                }
+                game_init(&r->game, &r->players[0], &r->players[1]);
+                started++;
+                break;
+            }
+            case JOURNAL_MOVE: {
+                const JournalCell *c = (const JournalCell *)rec;
+                if (p == NULL) break;
+                if (r->game.phase != PHASE_MOVE || c->cell >= BOARD_CELLS ||
+                    !game_check_move(&r->game, p, CELL_X(c->cell), CELL_Y(c->cell))) {
+                    anomaly(&illegal, file, off, id, "mouvement illégal");
+                    r->broken = 1;
+                    break;
+                }
+                game_apply_move(&r->game, p, CELL_X(c->cell), CELL_Y(c->cell));
+                break;
+            }
+            case JOURNAL_DESTROY: {
+                const JournalCell *c = (const JournalCell *)rec;
+                if (p == NULL) break;
+                if (r->game.phase != PHASE_DESTROY || c->cell >= BOARD_CELLS ||
+                    !game_check_destroy(&r->game, p, CELL_X(c->cell), CELL_Y(c->cell))) {
+                    anomaly(&illegal, file, off, id, "destruction illégale");
+                    r->broken = 1;
+                    break;
+                }
+                game_apply_destroy(&r->game, CELL_X(c->cell), CELL_Y(c->cell));
+                r->turns++;
+                turns++;
+                break;
+            }
+            case JOURNAL_TURN: {
+                const JournalTurn *t = (const JournalTurn *)rec;
+                if (p == NULL) break;
+                if (r->game.phase != PHASE_MOVE || t->to >= BOARD_CELLS || t->destroy >= BOARD_CELLS ||
+                    !game_check_turn(&r->game, p, CELL_X(t->to), CELL_Y(t->to), CELL_X(t->destroy),
+                                     CELL_Y(t->destroy))) {
+                    anomaly(&illegal, file, off, id, "tour illégal");
+                    r->broken = 1;
+                    break;
+                }
+                game_apply_turn(&r->game, p, CELL_X(t->to), CELL_Y(t->to), CELL_X(t->destroy), CELL_Y(t->destroy));
+                r->turns++;
+                turns++;
+                break;
+            }
+            case JOURNAL_END: {
+                JournalEnd e;
+                memcpy(&e, rec, sizeof(e));
+                if (!r->open) {
+                    anomaly(&orphans, file, off, id, "fin d'une partie jamais commencée");
+                    break;
+                }
+                if (r->broken) {
+                    r->open = 0;
+                    break;
+                }
+                replay_end(r, &e, shard, file, off);
+                break;
+            }
+        }
+        records++;
+        off += need;
+    }
+    bytes += off;
+    munmap((void *)data, size);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "gdv")) != -1) {
+        switch (opt) {
+            case 'g': print_games = 1; break;
+            case 'd': check_decided = 1; break;
+            case 'v': verbose = 1; break;
+            default:
+                fprintf(stderr, "Usage : %s [-g] [-d] [-v] fichier.isj...\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "Usage : %s [-g] [-d] [-v] fichier.isj...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    double start = now_s();
+    int failed = 0;
+    for (int i = optind; i < argc; i++) {
+        if (replay_file(argv[i]) < 0) failed = 1;
+    }
+    double elapsed = now_s() - start;
+
+    uint64_t still_open = 0;
+    for (int s = 0; s < MAX_SHARDS; s++) {
+        for (uint32_t id = 0; id < shards[s].size; id++) {
+            if (shards[s].games[id] && shards[s].games[id]->open) still_open++;
+        }
+    }
+
+    FILE *out = print_games ? stderr : stdout;
+    fprintf(out, "%d fichier(s), %lu octets, %lu enregistrements en %.3f s (%.1f M enregistrements/s, %.1f M tours/s)\n",
+            argc - optind, (unsigned long)bytes, (unsigned long)records, elapsed,
+            elapsed > 0 ? (double)records / elapsed / 1e6 : 0.0, elapsed > 0 ? (double)turns / elapsed / 1e6 : 0.0);
+    fprintf(out, "Parties : %lu commencées, %lu terminées, %lu sans fin ; %lu tours (%.1f par partie)\n",
+            (unsigned long)started, (unsigned long)finished, (unsigned long)still_open, (unsigned long)turns,
+            finished ? (double)turns / (double)(finished + still_open) : 0.0);
+    fprintf(out, "Gagnant : P1 %lu, P2 %lu ; fins : bloqué %lu, décidée %lu, temps %lu, forfait %lu\n",
+            (unsigned long)wins[1], (unsigned long)wins[2], (unsigned long)reasons[JOURNAL_END_BLOCKED],
+            (unsigned long)reasons[JOURNAL_END_DECIDED], (unsigned long)reasons[JOURNAL_END_TIMEOUT],
+            (unsigned long)reasons[JOURNAL_END_FORFEIT]);
+    fprintf(out, "Anomalies : %lu coups illégaux, %lu fins incohérentes, %lu débuts/fins orphelins, %lu fichiers tronqués\n",
+            (unsigned long)illegal, (unsigned long)bad_end, (unsigned long)orphans, (unsigned long)truncated);
+    if (check_decided) fprintf(out, "Fins décidées non vérifiables (budget du solveur) : %lu\n", (unsigned long)unchecked);
+
+    return (failed || illegal || bad_end) ? EXIT_FAILURE : 0;
+}
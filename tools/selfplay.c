@@ -0,0 +1,365 @@
+//
+// Tournoi sans réseau : parties moteur contre moteur (ou aléatoire) sur tous les cœurs
+// Usage : isola_selfplay [-n parties] [-j threads] [-a joueur] [-b joueur] [-o fichier] [-s graine] [-c]
+// Joueurs : random, greedy, d<profondeur> (moteur), t<ms> (moteur au temps)
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include "../include/game.h"
+#include "../include/engine.h"
+#include "../include/eval.h"
+#include "../include/tt.h"
+
+// --- Format des résultats ---
+// SelfPlayHeader puis un SelfPlayRecord par partie, dans l'ordre des parties
+#define SELFPLAY_MAGIC "ISOS"
+#define SELFPLAY_VERSION 1
+
+typedef struct __attribute__((packed)) {
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+} SelfPlayHeader;
+
+typedef struct __attribute__((packed)) {
+    uint32_t game;   // Numéro de la partie
+    uint8_t winner;  // 1 = P1, 2 = P2
+    uint8_t a_side;  // 1 si le joueur A avait P1, 2 s'il avait P2
+    uint16_t plies;  // Tours joués
+} SelfPlayRecord;
+
+#define JOB_GAMES 16 // Parties prises d'un coup dans sa propre file
+
+typedef enum { PLAYER_RANDOM, PLAYER_GREEDY, PLAYER_ENGINE } PlayerKind;
+
+typedef struct {
+    PlayerKind kind;
+    SearchLimits limits;
+    char name[16];
+} PlayerSpec;
+
+// File d'un thread : intervalle [lo, hi) de numéros de parties.
+// Le propriétaire prend par le bas, un voleur prend la moitié haute.
+typedef struct __attribute__((aligned(64))) {
+    pthread_mutex_t lock;
+    uint32_t lo;
+    uint32_t hi;
+} WorkQueue;
+
+typedef struct {
+    int id;
+    uint64_t rng;
+    uint64_t steals;
+} Worker;
+
+static PlayerSpec players[2];
+static WorkQueue *queues = NULL;
+static int worker_count = 1;
+static int check_rules = 0;
+static SelfPlayRecord *results = NULL;
+
+// --- Joueurs ---
+
+static uint64_t next_random(uint64_t *s) {
+    // xorshift64*
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545F4914F6CDD1DULL;
+}
+
+static int parse_player(const char *arg, PlayerSpec *p) {
+    memset(p, 0, sizeof(*p));
+    snprintf(p->name, sizeof(p->name), "%s", arg);
+    if (strcmp(arg, "random") == 0) p->kind = PLAYER_RANDOM;
+    else if (strcmp(arg, "greedy") == 0) p->kind = PLAYER_GREEDY;
+    else if (arg[0] == 'd' && atoi(arg + 1) > 0) {
+        p->kind = PLAYER_ENGINE;
+        p->limits.max_depth = atoi(arg + 1);
+    } else if (arg[0] == 't' && atoi(arg + 1) > 0) {
+        p->kind = PLAYER_ENGINE;
+        p->limits.time_ms = atoi(arg + 1);
+    } else {
+        return -1;
+    }
+    p->limits.threads = 1; // Le parallélisme vient des parties simultanées
+    return 0;
+}
+
+// Meilleur tour à un coup, tous les enfants évalués en un lot (eval.h)
+static Turn greedy_turn(const Game *g, const Turn *turns, int n, uint64_t *rng) {
+    int side = g->current_turn - 1;
+    Bitboard base = g->destroyed | g->pawns[side ^ 1];
+    Bitboard occupied[MAX_TURNS], me[MAX_TURNS], opp[MAX_TURNS];
+    EvalFeatures f[MAX_TURNS];
+
+    // Un seul tour : rien à comparer (et n >= 2 garantit que les tableaux sont remplis)
+    if (n <= 1) return turns[0];
+
+    for (int i = 0; i < n; i++) {
+        me[i] = BB_BIT(turns[i].to);
+        opp[i] = g->pawns[side ^ 1];
+        occupied[i] = base | me[i] | BB_BIT(turns[i].destroy);
+    }
+    eval_features(occupied, me, opp, n, f);
+
+    int best = -SCORE_WIN - 1;
+    int ties = 0;
+    Turn choice = turns[0];
+    for (int i = 0; i < n; i++) {
+        int score;
+        if (f[i].mobility[1] == 0 || !game_can_play(occupied[i], opp[i])) score = SCORE_WIN;
+        else if (f[i].mobility[0] == 0 || !game_can_play(occupied[i], me[i])) score = -SCORE_WIN;
+        else score = 4 * (f[i].mobility[0] - f[i].mobility[1]) + f[i].area[0] - f[i].area[1];
+
+        // Égalités départagées au hasard (sinon toutes les parties se ressemblent)
+        if (score > best) {
+            best = score;
+            ties = 1;
+            choice = turns[i];
+        } else if (score == best && next_random(rng) % (uint64_t)++ties == 0) {
+            choice = turns[i];
+        }
+    }
+    return choice;
+}
+
+static Turn choose_turn(const PlayerSpec *p, const Game *g, uint64_t *rng) {
+    Turn turns[MAX_TURNS];
+    int n = game_gen_turns(g, turns);
+
+    if (p->kind == PLAYER_RANDOM) return turns[next_random(rng) % (uint64_t)n];
+    if (p->kind == PLAYER_GREEDY) return greedy_turn(g, turns, n, rng);
+
+    // Premier tour au hasard : sinon deux moteurs déterministes rejouent la même partie
+    if (g->destroyed == 0) return turns[next_random(rng) % (uint64_t)n];
+    SearchResult r;
+    engine_search(g, &p->limits, &r);
+    return r.best;
+}
+
+// --- Une partie, par le même chemin que le serveur (Player, check puis apply) ---
+
+static void check_invariants(const Game *g, int game) {
+    if (g->hash != game_compute_hash(g)
+        || __builtin_popcountll(g->pawns[0]) != 1 || __builtin_popcountll(g->pawns[1]) != 1
+        || (g->pawns[0] & (g->pawns[1] | g->destroyed)) || (g->pawns[1] & g->destroyed)
+        || (g->destroyed & BB_ORIGINS)) {
+        fprintf(stderr, "Partie %d : état incohérent après %d destructions\n", game,
+                __builtin_popcountll(g->destroyed));
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void play_game(Worker *w, uint32_t index) {
+    Player pa, pb;
+    Game g;
+    memset(&pa, 0, sizeof(pa));
+    memset(&pb, 0, sizeof(pb));
+
+    // Le joueur A a P1 une partie sur deux
+    int a_side = (index & 1) ? 2 : 1;
+    game_init(&g, &pa, &pb);
+    const PlayerSpec *spec[2] = { &players[a_side == 1 ? 0 : 1], &players[a_side == 1 ? 1 : 0] };
+
+    int plies = 0;
+    while (g.winner == 0) {
+        Player *p = (g.current_turn == 1) ? g.p1 : g.p2;
+        Player *opp = (p == g.p1) ? g.p2 : g.p1;
+        Turn t = choose_turn(spec[g.current_turn - 1], &g, &w->rng);
+
+        int x = CELL_X(t.to), y = CELL_Y(t.to);
+        int dx = CELL_X(t.destroy), dy = CELL_Y(t.destroy);
+        if (!game_check_turn(&g, p, x, y, dx, dy)) {
+            fprintf(stderr, "Partie %u : tour refusé par game_check_turn\n", index);
+            exit(EXIT_FAILURE);
+        }
+        game_apply_turn(&g, p, x, y, dx, dy);
+        plies++;
+
+        // Règle de check_game_over() (src/main.c)
+        int num = (p == g.p1) ? 1 : 2;
+        if (game_check_loss(&g, opp)) g.winner = num;
+        else if (game_check_loss(&g, p)) g.winner = 3 - num;
+
+        if (check_rules) {
+            check_invariants(&g, (int)index);
+            if (game_turn_winner(&g) != g.winner) {
+                fprintf(stderr, "Partie %u : game_turn_winner diffère du serveur\n", index);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    SelfPlayRecord *r = &results[index];
+    r->game = index;
+    r->winner = (uint8_t)g.winner;
+    r->a_side = (uint8_t)a_side;
+    r->plies = (uint16_t)plies;
+}
+
+// --- Répartition du travail ---
+
+static int take_own(int id, uint32_t *lo, uint32_t *hi) {
+    WorkQueue *q = &queues[id];
+    pthread_mutex_lock(&q->lock);
+    *lo = q->lo;
+    *hi = (q->hi - q->lo > JOB_GAMES) ? q->lo + JOB_GAMES : q->hi;
+    q->lo = *hi;
+    pthread_mutex_unlock(&q->lock);
+    return *lo < *hi;
+}
+
+// Vole la moitié haute de la file la plus chargée et la met dans la sienne
+static int steal(Worker *w) {
+    int victim = -1;
+    uint32_t most = 0;
+    for (int i = 0; i < worker_count; i++) {
+        uint32_t left = queues[i].hi - queues[i].lo; // Lecture approximative, revérifiée sous verrou
+        if (i != w->id && left > most) {
+            most = left;
+            victim = i;
+        }
+    }
+    if (victim < 0) return 0;
+
+    WorkQueue *q = &queues[victim];
+    pthread_mutex_lock(&q->lock);
+    uint32_t left = q->hi - q->lo;
+    uint32_t lo = q->hi - (left + 1) / 2;
+    uint32_t hi = q->hi;
+    q->hi = lo;
+    pthread_mutex_unlock(&q->lock);
+    if (lo >= hi) return 1; // Quelqu'un est passé avant : on réessaie
+
+    WorkQueue *mine = &queues[w->id];
+    pthread_mutex_lock(&mine->lock);
+    mine->lo = lo;
+    mine->hi = hi;
+    pthread_mutex_unlock(&mine->lock);
+    w->steals++;
+    return 1;
+}
+
+static void *worker_thread(void *arg) {
+    Worker *w = arg;
+    uint32_t lo, hi;
+    while (1) {
+        if (take_own(w->id, &lo, &hi)) {
+            for (uint32_t i = lo; i < hi; i++) play_game(w, i);
+        } else if (!steal(w)) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    uint32_t games = 10000;
+    const char *path = NULL;
+    uint64_t seed = 1;
+    worker_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    parse_player("greedy", &players[0]);
+    parse_player("random", &players[1]);
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:j:a:b:o:s:c")) != -1) {
+        switch (opt) {
+            case 'n': games = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'j': worker_count = atoi(optarg); break;
+            case 'a':
+            case 'b':
+                if (parse_player(optarg, &players[opt == 'a' ? 0 : 1]) < 0) {
+                    fprintf(stderr, "Joueur inconnu : %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'o': path = optarg; break;
+            case 's': seed = strtoull(optarg, NULL, 10); break;
+            case 'c': check_rules = 1; break;
+            default:
+                fprintf(stderr, "Usage : %s [-n parties] [-j threads] [-a joueur] [-b joueur] [-o fichier] [-s graine] [-c]\n"
+                                "Joueurs : random, greedy, d<profondeur>, t<ms>\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (worker_count < 1) worker_count = 1;
+
+    if ((players[0].kind == PLAYER_ENGINE || players[1].kind == PLAYER_ENGINE) && tt_init(256) < 0) {
+        perror("Echec allocation table de transposition");
+        return EXIT_FAILURE;
+    }
+
+    results = calloc(games ? games : 1, sizeof(SelfPlayRecord));
+    queues = calloc((size_t)worker_count, sizeof(WorkQueue));
+    Worker *workers = calloc((size_t)worker_count, sizeof(Worker));
+    pthread_t *threads = calloc((size_t)worker_count, sizeof(pthread_t));
+    if (!results || !queues || !workers || !threads) {
+        perror("calloc");
+        return EXIT_FAILURE;
+    }
+
+    // Découpage initial en parts égales, le vol rééquilibre ensuite
+    for (int i = 0; i < worker_count; i++) {
+        pthread_mutex_init(&queues[i].lock, NULL);
+        queues[i].lo = (uint32_t)((uint64_t)games * (uint64_t)i / (uint64_t)worker_count);
+        queues[i].hi = (uint32_t)((uint64_t)games * (uint64_t)(i + 1) / (uint64_t)worker_count);
+        workers[i].id = i;
+        workers[i].rng = (seed + 1) * 0x9E3779B97F4A7C15ULL ^ (uint64_t)(i + 1) * 0xBF58476D1CE4E5B9ULL;
+    }
+
+    printf("%u parties, %d threads, eval %s : A = %s, B = %s\n", games, worker_count, eval_kernel_name(),
+           players[0].name, players[1].name);
+
+    double start = now_s();
+    for (int i = 0; i < worker_count; i++) pthread_create(&threads[i], NULL, worker_thread, &workers[i]);
+    uint64_t steals = 0;
+    for (int i = 0; i < worker_count; i++) {
+        pthread_join(threads[i], NULL);
+        steals += workers[i].steals;
+    }
+    double elapsed = now_s() - start;
+
+    // Statistiques
+    uint64_t a_wins = 0, p1_wins = 0, plies = 0;
+    int min_plies = 0, max_plies = 0;
+    for (uint32_t i = 0; i < games; i++) {
+        const SelfPlayRecord *r = &results[i];
+        if (r->winner == r->a_side) a_wins++;
+        if (r->winner == 1) p1_wins++;
+        plies += r->plies;
+        if (i == 0 || r->plies < min_plies) min_plies = r->plies;
+        if (r->plies > max_plies) max_plies = r->plies;
+    }
+    if (games > 0) {
+        printf("A gagne %.2f %% | B gagne %.2f %% | P1 gagne %.2f %%\n", 100.0 * (double)a_wins / games,
+               100.0 * (double)(games - a_wins) / games, 100.0 * (double)p1_wins / games);
+        printf("Longueur : moyenne %.2f tours (min %d, max %d)\n", (double)plies / games, min_plies, max_plies);
+    }
+    printf("%.3f s : %.0f parties/s, %.0f tours/s, %lu vols\n", elapsed, games / elapsed, (double)plies / elapsed,
+           (unsigned long)steals);
+
+    if (path) {
+        FILE *f = fopen(path, "wb");
+        SelfPlayHeader h;
+        memcpy(h.magic, SELFPLAY_MAGIC, 4);
+        h.version = SELFPLAY_VERSION;
+        h.count = games;
+        if (f == NULL || fwrite(&h, sizeof(h), 1, f) != 1
+            || fwrite(results, sizeof(SelfPlayRecord), games, f) != games || fclose(f) != 0) {
+            perror(path);
+            return EXIT_FAILURE;
+        }
+    }
+    return 0;
+}